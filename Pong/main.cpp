@@ -1,70 +1,19 @@
 #include "q_learner.hpp"
 #include <iostream>
-#include <fstream>
 #include <irrlicht/irrlicht.h>
 #include <boost/lexical_cast.hpp>
 
 #include "network.hpp"
+#include "games/pong.h"
+#include "util/series_writer.hpp"
 
 using namespace irr;
 
-const float BAT_SIZE = 0.05;
-
-struct PongGame
+// the old learner takes the raw positions instead of the one-hot state
+std::vector<float> data( const Pong& game )
 {
-	float ballx;
-	float bally;
-	float bvx;
-	float bvy;
-	float posy;
-
-	void reset()
-	{
-		ballx = 0.6;
-		bally = (rand() % 101) / 100.f;
-		bvx = 1;
-		bvy = (rand() % 101 - 50) / 20.f;
-		posy = 0.5;
-	}
-
-	float step( int ac )
-	{
-		ballx += 0.01*bvx;
-		bally += 0.01*bvy;
-
-		if( ac == 1 )
-			posy += 0.025;
-		else if(ac == 2)
-			posy -= 0.025;
-
-		if(bally > 1)
-		{
-			bally = 2 - bally;
-			bvy *= -1;
-		}
-
-		if(bally < 0)
-		{
-			bally = -bally;
-			bvy *= -1;
-		}
-
-		if( ballx > 1.0 )
-		{
-			if( std::abs(bally - posy) < BAT_SIZE )
-				return 1;
-			else
-				return -1;
-		}
-
-		return 0;
-	}
-
-	std::vector<float> data()
-	{
-		return std::vector<float>{ballx, bally, posy};
-	}
-};
+	return std::vector<float>{game.getBallX(), game.getBallY(), game.getBatY()};
+}
 
 void build_image(QLearner& l);
 
@@ -73,7 +22,8 @@ video::ITexture* texture = nullptr;
 
 int main()
 {
-	std::fstream rewf("reward.txt", std::fstream::out);
+	// training curve, written in the background
+	metrics::SeriesWriter reward_log("reward.csv", {"reward", "qval", "mse"});
 	QLearner learner(3, 3, 1e6, 1);
 	learner.setEpsilonSteps(1e6);
 	learner.setQNetwork( std::make_shared<Network<float>>(std::vector<LayerInfo>{
@@ -87,8 +37,7 @@ int main()
 	learner.setMiniBatchSize(32);
 	learner.setNetUpdateRate(10000);
 
-	PongGame game;
-	game.reset();
+	Pong game( true );
 	int ac = 2;
 	int i = 0;
 	int games = 0;
@@ -100,8 +49,7 @@ int main()
 	learner.setCallback( [&](const QLearner& l ) {
 			std::cout << games << "\n";
 			std::cout << learner.getCurrentEpsilon() << " - " << learner.getAverageEpisodeReward() << "\n";
-			rewf << learner.getAverageEpisodeReward() << " " << learner.getAverageQuality() << " " << learner.getAverageError() << "\n";
-			rewf.flush();
+			reward_log.record({learner.getAverageEpisodeReward(), learner.getAverageQuality(), learner.getAverageError()});
 			std::cout << learner.getNumberLearningSteps() << "\n";
 			build_image(learner);
 			std::cout << " - - - - - - - - - - \n";
@@ -138,13 +86,13 @@ int main()
 	{
 		step++;
 		float r = game.step(ac);
-		ac = learner.learn_step( game.data(), r, r != 0 );
+		ac = learner.learn_step( data(game), r, r != 0 );
 		step++;
 		if(drawing && games % 10000 < 0 )
 		{
 			device->getVideoDriver()->beginScene();
-			device->getVideoDriver()->draw2DPolygon( core::position2di(game.ballx * 400, game.bally * 400+100), 10);
-			device->getVideoDriver()->draw2DLine(core::position2di(400, (game.posy-BAT_SIZE)*400+100), core::position2di(400, (game.posy+BAT_SIZE)*400+100));
+			device->getVideoDriver()->draw2DPolygon( core::position2di(game.getBallX() * 400, game.getBallY() * 400+100), 10);
+			device->getVideoDriver()->draw2DLine(core::position2di(400, (game.getBatY()-pong::BAT_SIZE)*400+100), core::position2di(400, (game.getBatY()+pong::BAT_SIZE)*400+100));
 
 			float q = learner.getCurrentQuality();
 			float r = learner.getAverageEpisodeReward();
@@ -171,7 +119,7 @@ int main()
 
 		if( r != 0)
 		{
-			game.reset();
+			game.restart();
 			games++;
 		}
 
@@ -184,16 +132,13 @@ void build_image(QLearner& l)
 {
 	std::vector<unsigned char> grayscale(100*100*3);
 
-	PongGame game;
-	game.reset();
-	game.bvx = 1;
+	Pong game( true );
 	for(int y = 0; y < 100; ++y)
 	{
 		for(int x = 0; x < 100; ++x)
 		{
-			game.ballx = x / 100.0;
-			game.bally = y / 100.0;
-			const float* r = l.assess( game.data() );
+			game.setState( x / 100.0, y / 100.0, game.getBallVY(), game.getBatY() );
+			const float* r = l.assess( data(game) );
 			grayscale[(100*y+x)*3] = (r[0] > r[1] && r[0] > r[2]) ? unsigned((r[0]+1)*127) : 0;
 			grayscale[(100*y+x)*3+1] = (r[1] > r[0] && r[1] > r[2]) ? unsigned((r[1]+1)*127) : 0;
 			grayscale[(100*y+x)*3+2] = (r[2] > r[0] && r[2] > r[1]) ? unsigned((r[2]+1)*127) : 0;
@@ -0,0 +1,177 @@
+#include "qlearner/experiment.hpp"
+#include "qlearner/sweep.hpp"
+#include "qlearner/population.hpp"
+#include "qlearner/qlearner.hpp"
+#include "games/collect.h"
+#include "games/pong.h"
+
+#include <boost/property_tree/json_parser.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace qlearn;
+using boost::property_tree::ptree;
+
+namespace
+{
+	std::unique_ptr<Game> make_game( const Experiment& experiment, std::uint64_t seed )
+	{
+		if( experiment.game() == "collect" )
+			return std::make_unique<Collect>( seed );
+		else if( experiment.game() == "pong" )
+			return std::make_unique<Pong>( false, seed );
+		throw std::invalid_argument("unknown game '" + experiment.game() + "'");
+	}
+	
+	std::vector<double> numbers( const ptree& list )
+	{
+		std::vector<double> values;
+		for(const auto& entry : list)
+			values.push_back( entry.second.get_value<double>() );
+		return values;
+	}
+	
+	// a parameter is either a list of values, or an object with one of "uniform", "integer" or
+	// "log_uniform" and the range as [low, high].
+	void add_parameter( SearchSpace& space, const std::string& path, const ptree& node )
+	{
+		if( node.empty() || !node.begin()->first.empty() )
+		{
+			if( node.size() != 1 )
+				throw std::invalid_argument("parameters." + path + ": expected a list of values or one range");
+			const std::string& kind = node.begin()->first;
+			auto range = numbers( node.begin()->second );
+			if( range.size() != 2 )
+				throw std::invalid_argument("parameters." + path + "." + kind + ": expected [low, high]");
+			if( kind == "uniform" )
+				space.uniform( path, range[0], range[1] );
+			else if( kind == "integer" )
+				space.uniform( path, range[0], range[1], true );
+			else if( kind == "log_uniform" )
+				space.log_uniform( path, range[0], range[1] );
+			else
+				throw std::invalid_argument("parameters." + path + ": unknown range '" + kind + "'");
+		} else
+		{
+			std::vector<std::string> values;
+			for(const auto& entry : node)
+				values.push_back( entry.second.data() );
+			space.choice( path, std::move(values) );
+		}
+	}
+	
+	std::vector<int> core_list( const ptree& description )
+	{
+		std::vector<int> cores;
+		if( auto list = description.get_child_optional( "cores" ) )
+		{
+			for(double core : numbers( *list ))
+				cores.push_back( (int)core );
+		}
+		return cores;
+	}
+	
+	// population based training of "population" members, whose initial hyperparameters are drawn from
+	// the search space.
+	void run_population( const Experiment& experiment, const SearchSpace& space, const ptree& description, const char* results )
+	{
+		PopulationOptions options;
+		options.steps = description.get( "steps", options.steps );
+		options.interval = description.get( "interval", options.interval );
+		options.truncation = description.get( "truncation", options.truncation );
+		options.perturbation = description.get( "perturbation", options.perturbation );
+		options.seed = description.get( "seed", options.seed );
+		options.workers = description.get( "workers", options.workers );
+		options.cores = core_list( description );
+		
+		PopulationTrainer trainer( experiment, make_game, options );
+		trainer.run( space.sample( description.get<std::size_t>( "population" ), options.seed ) );
+		
+		if( results )
+		{
+			std::ofstream out( results );
+			trainer.writeTable( out );
+		}
+		trainer.writeTable( std::cout );
+		
+		// the best member can be loaded like any other checkpoint
+		if( auto path = description.get_optional<std::string>( "checkpoint" ) )
+		{
+			std::size_t best = trainer.getBest();
+			trainer.getLearner( best ).save( *path, trainer.getSolver( best ) );
+		}
+	}
+}
+
+// usage: sweep experiment.json sweep.json [results.csv]
+// sweep.json contains the search space as "parameters", which maps paths in the experiment to values, e.g.
+// { "trials": 16, "steps": 200000, "eval_interval": 20000, "workers": 4,
+//   "parameters": { "learner.batch_size": [32, 64], "optimizer.rate": { "log_uniform": [1e-5, 1e-3] } } }
+// Without "trials", all combinations of the values are run.
+// With "population": <members>, the members are trained with population based training instead, see
+// PopulationTrainer. "interval", "truncation", "perturbation" and "checkpoint" configure it.
+int main( int argc, char** argv )
+{
+	if( argc < 3 )
+	{
+		std::cerr << "usage: sweep experiment.json sweep.json [results.csv]\n";
+		return 1;
+	}
+	
+	try
+	{
+		Experiment experiment = Experiment::fromFile( argv[1] );
+		ptree description;
+		boost::property_tree::read_json( argv[2], description );
+		
+		SearchSpace space;
+		// the fallback has to outlive the loop, get_child returns a reference to it
+		const ptree empty;
+		const ptree& parameters = description.get_child( "parameters", empty );
+		for(const auto& parameter : parameters)
+			add_parameter( space, parameter.first, parameter.second );
+		
+		if( description.count( "population" ) > 0 )
+		{
+			run_population( experiment, space, description, argc > 3 ? argv[3] : nullptr );
+			return 0;
+		}
+		
+		SweepOptions options;
+		options.steps = description.get( "steps", options.steps );
+		options.eval_interval = description.get( "eval_interval", options.eval_interval );
+		options.stop_quantile = description.get( "stop_quantile", options.stop_quantile );
+		options.min_trials = description.get( "min_trials", options.min_trials );
+		options.workers = description.get( "workers", options.workers );
+		options.cores_per_trial = description.get( "cores_per_trial", options.cores_per_trial );
+		options.cores = core_list( description );
+		
+		std::size_t count = description.get( "trials", std::size_t(0) );
+		auto trials = count > 0 ? space.sample( count, description.get( "seed", std::uint64_t(1) ) ) : space.grid();
+		
+		SweepRunner runner( experiment, make_game, options );
+		auto results = runner.run( trials );
+		
+		if( argc > 3 )
+		{
+			std::ofstream out( argv[3] );
+			SweepRunner::writeTable( out, space.getPaths(), results );
+		}
+		
+		// best first, failed trials last
+		std::sort( results.begin(), results.end(), []( const TrialResult& a, const TrialResult& b )
+		{
+			if( a.error.empty() != b.error.empty() )
+				return a.error.empty();
+			return a.reward > b.reward;
+		} );
+		SweepRunner::writeTable( std::cout, space.getPaths(), results );
+	} catch( std::exception& e )
+	{
+		std::cerr << e.what() << "\n";
+		return 1;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "util/alloc_count.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace bench
+{
+	struct Result
+	{
+		double ns_per_op;
+		double gflops;
+		double allocs_per_op;
+	};
+
+	// runs op repeatedly for at least min_time seconds, after a warm-up phase.
+	// flops is the number of floating point operations of a single op, used to report GFLOP/s.
+	template<class F>
+	Result measure( F&& op, double flops, double min_time = 0.2 )
+	{
+		using clock = std::chrono::steady_clock;
+		for(int i = 0; i < 10; ++i)
+			op();
+
+		std::size_t iterations = 0;
+		std::size_t allocations = 0;
+		double elapsed = 0;
+		std::size_t batch = 1;
+		while( elapsed < min_time )
+		{
+			util::AllocationScope allocs;
+			auto start = clock::now();
+			for(std::size_t i = 0; i < batch; ++i)
+				op();
+			elapsed += std::chrono::duration<double>( clock::now() - start ).count();
+			allocations += allocs.count();
+			iterations += batch;
+			batch *= 2;
+		}
+
+		Result result;
+		result.ns_per_op = elapsed / iterations * 1e9;
+		result.gflops = flops / result.ns_per_op;
+		result.allocs_per_op = double(allocations) / iterations;
+		return result;
+	}
+
+	inline void print_header()
+	{
+		std::printf("%-32s %8s %8s %14s %10s %12s\n", "benchmark", "width", "batch", "ns/op", "GFLOP/s", "allocs/op");
+	}
+
+	inline void print( const std::string& name, std::size_t width, std::size_t batch, const Result& result )
+	{
+		std::printf("%-32s %8zu %8zu %14.1f %10.3f %12.2f\n", name.c_str(), width, batch,
+					result.ns_per_op, result.gflops, result.allocs_per_op);
+	}
+}
@@ -0,0 +1,264 @@
+#include "bench.hpp"
+
+#include "net/fc_layer.hpp"
+#include "net/relu_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/network.hpp"
+#include "net/computation_graph.hpp"
+#include "net/computation_node.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+#include "qlearner/memory.hpp"
+#include "qlearner/action.h"
+#include "games/collect_batch.h"
+#include "games/pong_batch.h"
+
+#include <random>
+#include <vector>
+
+using namespace net;
+using namespace bench;
+
+namespace
+{
+	std::string filter;
+
+	bool enabled( const std::string& name )
+	{
+		return filter.empty() || name.find( filter ) != std::string::npos;
+	}
+
+	std::vector<Vector> random_inputs( std::size_t width, std::size_t batch )
+	{
+		std::vector<Vector> inputs;
+		for(std::size_t i = 0; i < batch; ++i)
+			inputs.push_back( Vector::Random(width) );
+		return inputs;
+	}
+
+	std::unique_ptr<Solver> make_solver()
+	{
+		return std::make_unique<Solver>( std::make_unique<RMSProp>(0.9, 0.001, 0.01) );
+	}
+
+	Network make_mlp( std::size_t width, std::size_t depth )
+	{
+		Network network;
+		for(std::size_t i = 0; i < depth; ++i)
+		{
+			network << FcLayer( Matrix::Random(width, width) / width );
+			network << ReLULayer( Matrix::Zero(width, 1) );
+		}
+		return network;
+	}
+
+	// benchmarks forward and backward pass of a single layer, fed by an input node.
+	template<class Layer>
+	void bench_layer( const std::string& name, Layer layer, std::size_t width, std::size_t batch,
+					  double forward_flops, double backward_flops )
+	{
+		auto inputs = random_inputs( width, batch );
+		auto source = std::make_shared<ComputationNode>( inputs[0] );
+		ComputationNode node( source, Vector(), &layer );
+		Vector back;
+		Vector error = Vector::Random( layer.getOutputSize() );
+		auto solver = make_solver();
+
+		if( enabled( name + "::process" ) )
+		{
+			Vector out;
+			print( name + "::process", width, batch, measure( [&]() {
+				for(const auto& in : inputs)
+					layer.process( in, out );
+			}, forward_flops * batch ) );
+		}
+
+		if( enabled( name + "::backward" ) )
+		{
+			layer.forward( *source, node );
+			print( name + "::backward", width, batch, measure( [&]() {
+				for(std::size_t i = 0; i < batch; ++i)
+					layer.backward( error, back, node, *solver );
+			}, backward_flops * batch ) );
+		}
+	}
+
+	void bench_graph( std::size_t width, std::size_t batch )
+	{
+		const std::size_t depth = 3;
+		Network network = make_mlp( width, depth );
+		ComputationGraph graph( network );
+		auto inputs = random_inputs( width, batch );
+		Vector error = Vector::Random( width );
+		auto solver = make_solver();
+		const double fc_flops = 2.0 * width * width * depth;
+
+		if( enabled("ComputationGraph::forward") )
+		{
+			print( "ComputationGraph::forward", width, batch, measure( [&]() {
+				for(const auto& in : inputs)
+					graph.forward( in );
+			}, fc_flops * batch ) );
+		}
+
+		if( enabled("ComputationGraph::backpropagate") )
+		{
+			print( "ComputationGraph::backpropagate", width, batch, measure( [&]() {
+				for(const auto& in : inputs)
+				{
+					graph.forward( in );
+					graph.backpropagate( error, *solver );
+				}
+			}, 3 * fc_flops * batch ) );
+		}
+
+		if( enabled("Solver::update(RMSProp)") )
+		{
+			graph.forward( inputs[0] );
+			graph.backpropagate( error, *solver );
+			// rms update, division, sqrt, scaling and subtraction per parameter
+			double params = depth * (width * width + width);
+			print( "Solver::update(RMSProp)", width, 1, measure( [&]() {
+				network.update( *solver );
+			}, 8 * params ) );
+		}
+
+		if( enabled("Solver::update(RMSProp<double>)") )
+		{
+			Solver double_solver( std::make_unique<BasicRMSProp<double>>(0.9, 0.001, 0.01) );
+			graph.forward( inputs[0] );
+			graph.backpropagate( error, double_solver );
+			double params = depth * (width * width + width);
+			print( "Solver::update(RMSProp<double>)", width, 1, measure( [&]() {
+				network.update( double_solver );
+			}, 8 * params ) );
+		}
+
+		if( enabled("getAction") )
+		{
+			print( "getAction", width, batch, measure( [&]() {
+				for(const auto& in : inputs)
+					qlearn::getAction( graph, in );
+			}, fc_flops * batch ) );
+		}
+	}
+
+	void bench_memory( std::size_t width, std::size_t batch )
+	{
+		qlearn::MemoryCache memory( 10000 );
+		util::Random random( 1 );
+		Vector situation = Vector::Random( width );
+		Vector future = Vector::Random( width );
+		for(std::size_t i = 0; i < 10000; ++i)
+			memory.emplace( situation, 1, future, 0.5, false );
+
+		if( enabled("MemoryCache::emplace") )
+		{
+			print( "MemoryCache::emplace", width, batch, measure( [&]() {
+				for(std::size_t i = 0; i < batch; ++i)
+					memory.emplace( situation, 1, future, 0.5, false );
+			}, 0 ) );
+		}
+
+		if( enabled("MemoryCache::get_random") )
+		{
+			float sum = 0;
+			print( "MemoryCache::get_random", width, batch, measure( [&]() {
+				for(std::size_t i = 0; i < batch; ++i)
+					sum += memory.get_random( random ).reward;
+			}, 0 ) );
+		}
+	}
+
+	// one environment step and observation for every game of the batch
+	void bench_collect_batch( std::size_t batch )
+	{
+		if( !enabled("CollectBatch") )
+			return;
+
+		CollectBatch games( batch, 1 );
+		std::vector<int> actions( batch );
+		std::vector<float> rewards( batch );
+		Matrix states;
+		int step = 0;
+		print( "CollectBatch::step", collect::STATE_SIZE, batch, measure( [&]() {
+			for(std::size_t i = 0; i < batch; ++i)
+				actions[i] = (step + i) % collect::NUM_ACTIONS;
+			++step;
+			games.step( actions.data(), rewards.data() );
+			games.getStates( states );
+		}, 0 ) );
+	}
+
+	// action selection for a batch of states, for different exploration rates
+	void bench_epsilon_greedy( std::size_t batch )
+	{
+		if( !enabled("EpsilonGreedy") )
+			return;
+
+		PongBatch games( batch, 1 );
+		Matrix states;
+		games.getStates( states );
+		Network network;
+		network << FcLayer(Matrix::Random(30, 30) / 5) << TanhLayer(Matrix::Zero(30, 1));
+		network << FcLayer(Matrix::Random(3, 30) / 5) << TanhLayer(Matrix::Zero(3, 1));
+		ComputationGraph graph( network );
+		qlearn::EpsilonGreedy policy( pong::NUM_ACTIONS, util::Random( 1 ) );
+
+		for(float epsilon : {1.f, 0.5f, 0.1f, 0.f})
+		{
+			std::string name = "EpsilonGreedy::select(" + std::to_string( epsilon ).substr( 0, 3 ) + ")";
+			print( name, pong::STATE_SIZE, batch, measure( [&]() {
+				policy.select( graph, states, epsilon );
+			}, 0 ) );
+		}
+	}
+
+	void bench_pong_batch( std::size_t batch )
+	{
+		if( !enabled("PongBatch") )
+			return;
+
+		PongBatch games( batch, 1, true );
+		std::vector<int> actions( batch );
+		std::vector<float> rewards( batch );
+		Matrix states;
+		int step = 0;
+		print( "PongBatch::step", pong::STATE_SIZE, batch, measure( [&]() {
+			for(std::size_t i = 0; i < batch; ++i)
+				actions[i] = (step + i) % pong::NUM_ACTIONS;
+			++step;
+			games.step( actions.data(), rewards.data() );
+			games.getStates( states );
+		}, 0 ) );
+	}
+}
+
+int main( int argc, char** argv )
+{
+	if( argc > 1 )
+		filter = argv[1];
+
+	const std::size_t widths[] = {16, 64, 256};
+	const std::size_t batches[] = {1, 32};
+
+	print_header();
+	for(std::size_t width : widths)
+	{
+		for(std::size_t batch : batches)
+		{
+			double w = width;
+			bench_layer( "FcLayer", FcLayer( Matrix::Random(width, width) ), width, batch, 2 * w * w, 4 * w * w );
+			bench_layer( "ReLULayer", ReLULayer( Matrix::Zero(width, 1) ), width, batch, 2 * w, 2 * w );
+			bench_layer( "TanhLayer", TanhLayer( Matrix::Zero(width, 1) ), width, batch, 2 * w, 4 * w );
+			bench_graph( width, batch );
+			bench_memory( width, batch );
+		}
+	}
+
+	for(std::size_t batch : {1, 32, 256})
+		bench_collect_batch( batch );
+	for(std::size_t batch : {1, 256, 4096})
+		bench_pong_batch( batch );
+	bench_epsilon_greedy( 256 );
+}
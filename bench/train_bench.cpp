@@ -0,0 +1,214 @@
+#include "qlearner/qlearner.hpp"
+#include "qlearner/timings.hpp"
+#include "qlearner/experiment.hpp"
+#include "net/fc_layer.hpp"
+#include "net/relu_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+#include "net/network.hpp"
+#include "games/collect.h"
+#include "games/pong.h"
+#include "util/trace.hpp"
+#include "util/alloc_count.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+
+using namespace net;
+using namespace qlearn;
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	double seconds( StepTimings::duration d )
+	{
+		return std::chrono::duration<double>( d ).count();
+	}
+
+	// peak resident set size of the process, in MB
+	double peak_rss()
+	{
+		struct rusage usage;
+		getrusage( RUSAGE_SELF, &usage );
+		return usage.ru_maxrss / 1024.0;
+	}
+
+	// runs the learner for a fixed number of environment steps, without any rendering, and prints
+	// throughput and the time spent in each phase.
+	void run( const std::string& name, Game& game, QLearner& learner, Solver& solver, std::size_t steps )
+	{
+		StepTimings timings;
+		timings.allocation_counter = util::allocation_count;
+		learner.setTimings( &timings );
+		StepTimings::duration env_time{};
+#ifdef DQN_TRACING
+		trace::reset();
+#endif
+
+		Vector state;
+		game.restart();
+		game.getCurrentState( state );
+		int action = 0;
+
+		auto start = clock::now();
+		for(std::size_t i = 0; i < steps; ++i)
+		{
+			auto env_start = clock::now();
+			float reward = game.step( action );
+			bool terminal = game.isFinished();
+			game.getCurrentState( state );
+			env_time += std::chrono::duration_cast<StepTimings::duration>( clock::now() - env_start );
+
+			action = learner.learn_step( state, reward, terminal || reward != 0, solver );
+
+			if( terminal )
+			{
+				env_start = clock::now();
+				game.restart();
+				env_time += std::chrono::duration_cast<StepTimings::duration>( clock::now() - env_start );
+			}
+		}
+		double total = std::chrono::duration<double>( clock::now() - start ).count();
+
+		std::printf( "%s: %zu env steps, %zu learning steps in %.2f s\n", name.c_str(), steps, learner.getLearningSteps(), total );
+		std::printf( "  %-12s %12.0f /s\n", "env steps", steps / total );
+		std::printf( "  %-12s %12.0f /s\n", "learn steps", learner.getLearningSteps() / total );
+		std::printf( "  %-12s %10.3f s %6.1f %%\n", "env", seconds(env_time), 100 * seconds(env_time) / total );
+		for(std::size_t p = 0; p < (std::size_t)Phase::COUNT; ++p)
+		{
+			double t = seconds( timings[(Phase)p] );
+			std::printf( "  %-12s %10.3f s %6.1f %% %10.3f allocs/step\n", getPhaseName((Phase)p), t, 100 * t / total,
+						 double(timings.allocations[p]) / steps );
+		}
+		std::printf( "  %-12s %10.1f MB\n", "peak RSS", peak_rss() );
+#ifdef DQN_TRACING
+		std::fflush( stdout );
+		trace::report( std::cout );
+		// DQN_CHROME_TRACE=<file> additionally exports the individual scopes
+		if( const char* path = std::getenv( "DQN_CHROME_TRACE" ) )
+		{
+			std::ofstream out( name + "_" + path );
+			trace::writeChromeTrace( out );
+		}
+#endif
+
+		learner.setTimings( nullptr );
+	}
+
+	std::unique_ptr<Solver> make_solver( double lambda, double rate, double epsilon )
+	{
+		return std::make_unique<Solver>( std::make_unique<RMSProp>( lambda, rate, epsilon ) );
+	}
+
+	void bench_collect( std::size_t steps, unsigned seed )
+	{
+		Collect game( seed );
+		game.restart();
+		Vector state;
+		game.getCurrentState( state );
+
+		// same setup as game_test.cpp
+		Network network;
+		network << FcLayer((Matrix::Random(50, state.size()).array()) / 5);
+		network << ReLULayer(Matrix::Zero(50, 1));
+		network << FcLayer((Matrix::Random(50, 50).array()) / 7);
+		network << ReLULayer(Matrix::Zero(50, 1));
+		network << FcLayer((Matrix::Random(game.getNumInputs(), 50).array()) / 7);
+		network << ReLULayer(Matrix::Zero(game.getNumInputs(), 1));
+
+		QLearner learner( Config( state.size(), game.getNumInputs(), 30000).epsilon_steps(200000)
+																		  .update_interval(2000)
+																		  .batch_size(64)
+																		  .init_memory_size(1000)
+																		  .init_epsilon_time(3000)
+																		  .discount_factor(0.7)
+																		  .seed(seed), std::move(network) );
+		auto solver = make_solver( 0.9, 0.0005, 0.001 );
+		run( "collect", game, learner, *solver, steps );
+	}
+
+	void bench_pong( std::size_t steps, unsigned seed )
+	{
+		Pong game( false, seed );
+
+		// same setup as pong.cpp, but with a smaller memory
+		Network network;
+		network << FcLayer(Matrix::Random(30, 30).array() / 5);
+		network << TanhLayer(Matrix::Zero(30, 1));
+		network << FcLayer(Matrix::Random(30, 30).array() / 5);
+		network << TanhLayer(Matrix::Zero(30, 1));
+		network << FcLayer(Matrix::Random(3, 30).array() / 5);
+		network << TanhLayer(Matrix::Zero(3, 1));
+
+		QLearner learner( Config(30, 3, 200000).epsilon_steps(2000000)
+											   .update_interval(10000)
+											   .batch_size(32)
+											   .init_memory_size(10000)
+											   .init_epsilon_time(100000)
+											   .discount_factor(0.98)
+											   .seed(seed), std::move(network) );
+		auto solver = make_solver( 0.95, 0.0001, 0.000001 );
+		run( "pong", game, learner, *solver, steps );
+	}
+
+	// runs the setup described by an experiment file, see Experiment
+	void bench_experiment( const std::string& path, std::size_t steps, unsigned seed )
+	{
+		Experiment experiment = Experiment::fromFile( path );
+		std::unique_ptr<Game> game;
+		if( experiment.game() == "collect" )
+			game = std::make_unique<Collect>( seed );
+		else if( experiment.game() == "pong" )
+			game = std::make_unique<Pong>( false, seed );
+		else
+			throw std::invalid_argument( path + ": unknown game '" + experiment.game() + "'" );
+
+		Vector state;
+		game->getCurrentState( state );
+		Config config = experiment.config();
+		if( (std::size_t)state.size() != config.input_size() || (std::size_t)game->getNumInputs() != config.action_count() )
+			throw std::invalid_argument( path + ": inputs and actions do not match the game" );
+
+		QLearner learner( config.seed( seed ), experiment.makeNetwork( seed ) );
+		auto solver = experiment.makeSolver();
+		run( experiment.game(), *game, learner, *solver, steps );
+	}
+}
+
+// usage: train_bench [steps] [seed] [collect|pong|experiment.json]
+int main( int argc, char** argv )
+{
+	std::size_t steps = argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 100000;
+	unsigned seed = argc > 2 ? std::strtoul( argv[2], nullptr, 10 ) : 1;
+	std::string only = argc > 3 ? argv[3] : "";
+#ifdef DQN_TRACING
+	trace::enableChromeTrace( std::getenv( "DQN_CHROME_TRACE" ) != nullptr );
+#endif
+
+	if( only.size() > 5 && only.compare( only.size() - 5, 5, ".json" ) == 0 )
+	{
+		bench_experiment( only, steps, seed );
+		return 0;
+	}
+
+	// the network initialization uses rand(), the games and the learners are seeded directly
+	if( only.empty() || only == "collect" )
+	{
+		std::srand( seed );
+		bench_collect( steps, seed );
+	}
+	if( only.empty() || only == "pong" )
+	{
+		std::srand( seed );
+		bench_pong( steps, seed );
+	}
+}
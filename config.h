@@ -1,16 +1,30 @@
+#pragma once
+
 #include <Eigen/Dense>
 
-typedef float number_t;
+// scalar of the network parameters and of the forward and backward passes.
+// Build with -DDQN_SCALAR=double for a double precision network.
+#ifndef DQN_SCALAR
+#define DQN_SCALAR float
+#endif
+typedef DQN_SCALAR number_t;
+
+// scalar for sums that lose too much to rounding in number_t, e.g. the TD targets and the loss.
+typedef double accum_t;
 
-using Matrix = Eigen::Matrix<number_t, Eigen::Dynamic, Eigen::Dynamic>;
-using Vector = Eigen::Matrix<number_t, Eigen::Dynamic, 1>;
+template<class Scalar>
+using MatrixT = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+template<class Scalar>
+using VectorT = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+using Matrix = MatrixT<number_t>;
+using Vector = VectorT<number_t>;
 
 // fwd declarations
-namespace net 
+namespace net
 {
 	class ILayer;
 	class Solver;
 	class ComputationNode;
 	class Network;
 }
-
@@ -16,8 +16,16 @@
 #include "net/solver.hpp"
 #include "net/rmsprop.hpp"
 #include "net/network.hpp"
+#include "net/checkpoint_writer.hpp"
+#include "util/trace.hpp"
+#include "util/random.hpp"
+#include "util/metrics.hpp"
+#include "util/metrics_server.hpp"
+#include "util/series_writer.hpp"
+#include "qlearner/learner_metrics.hpp"
 
 #include "games/collect.h"
+#include "games/render.h"
 
 
 using namespace net;
@@ -43,45 +51,55 @@ void learn_thread( Network& target_net, ComputationGraph& target_graph, Game& ga
 	network << FcLayer((Matrix::Random(game.getNumInputs(), 50).array()) / 7);
 	network << ReLULayer(Matrix::Zero(game.getNumInputs(), 1));
 	
-	QLearner learner( Config( state.size(), game.getNumInputs(), 30000).epsilon_steps(200000)
+	const std::size_t MEMORY = 30000;
+	QLearner learner( Config( state.size(), game.getNumInputs(), MEMORY).epsilon_steps(200000)
 																		.update_interval(2000)
 																		.batch_size(64)
 																		.init_memory_size(1000)
 																		.init_epsilon_time(3000)
+																		.learning_rate(Schedule::piecewise({ {0, 0.0005}, {320000, 0.00025} }))
 																		.discount_factor(0.7), std::move(network) );
 	
-	auto prop = std::unique_ptr<RMSProp>(new RMSProp(0.9, 0.0005, 0.001));
-	RMSProp* rmsprop = prop.get();
-	Solver solver( std::move(prop) );
+	Solver solver( std::unique_ptr<RMSProp>(new RMSProp(0.9, 0.0005, 0.001)) );
 	
-	std::fstream rewf("reward.txt", std::fstream::out);
+	// training curve, written in the background. DQN_METRICS_PORT / DQN_METRICS_SOCKET enables a
+	// Prometheus endpoint.
+	metrics::SeriesWriter reward_log("reward.csv", {"reward", "qval", "mse", "epsilon"});
+	metrics::Registry registry;
+	LearnerMetrics learner_metrics( registry, MEMORY );
+	auto metrics_server = metrics::MetricsServer::fromEnvironment( registry );
+	AsyncCheckpointWriter checkpoints;
 
 	int ac = 2;
 	auto last_time = std::chrono::high_resolution_clock::now();
 	bool run = true;
-	int episodes = 0;
 	
 	learner.setCallback( [&](const QLearner& l, const Stats& stats ) 
 	{
-		std::cout << episodes << ": " << learner.getCurrentEpsilon() << "\n";
+		std::cout << learner.getLearningSteps() << ": " << learner.getCurrentEpsilon() << "\n";
 		std::cout << stats.getSmoothReward() << " (" <<  stats.getSmoothQVal() << ", " << stats.getSmoothMSE() << ")\n";
-		rewf << stats.getSmoothReward() << "\t" <<  stats.getSmoothQVal() << "\t" << stats.getSmoothMSE() << " " << learner.getCurrentEpsilon()  << "\n";
-		rewf.flush();
+		reward_log.record({stats.getSmoothReward(), stats.getSmoothQVal(), stats.getSmoothMSE(), learner.getCurrentEpsilon()});
 //		std::cout << learner.getNumberLearningSteps() << "\n";
 		std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(
 					std::chrono::high_resolution_clock::now() - last_time).count() << " ms\n";
 		last_time = std::chrono::high_resolution_clock::now();
+#ifdef DQN_TRACING
+		trace::report( std::cout );
+		trace::reset();
+#endif
 		std::cout << " - - - - - - - - - - \n";
-		std::lock_guard<std::mutex> lck(mTargetNet);
-		target_net = learner.network().clone();
-		target_graph = ComputationGraph(target_net);
+		if( !checkpoints.getLastError().empty() )
+			std::cout << "checkpoint failed: " << checkpoints.getLastError() << "\n";
+		learner.save( checkpoints, "collect.ckpt", solver, "collect.memory" );
 		
-		if(episodes > 160)
+		std::lock_guard<std::mutex> lck(mTargetNet);
+		if( target_net.is_compatible( learner.network() ) )
 		{
-			prop->setRate(0.00025);
-		} else if(episodes > 80)
+			target_net.copy_parameters_from( learner.network() );
+		} else
 		{
-			prop->setRate(0.0005);
+			target_net = learner.network().clone();
+			target_graph = ComputationGraph(target_net);
 		}
 	} );
 	
@@ -92,7 +110,9 @@ void learn_thread( Network& target_net, ComputationGraph& target_graph, Game& ga
 		try
 		{
 			game.getCurrentState(state);
+			auto start = std::chrono::steady_clock::now();
 			ac = learner.learn_step( state, r, r != 0, solver );
+			learner_metrics.step( learner, std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() );
 		} catch( std::exception& e)
 		{
 			std::cout << "EXCEPTION " << e.what() << "\n";
@@ -113,18 +133,18 @@ int main()
 	Collect game;
 	game.restart();
 	
-	Collect learn_game;
+	Collect learn_game( 1 );
 	
 	Network network;
 	ComputationGraph graph(network);
 	std::thread learner( learn_thread, std::ref(network), std::ref(graph), std::ref(learn_game) );
 	learner.detach();
-	
-	std::fstream rewf("reward.txt", std::fstream::out);
 
 	device = createDevice(video::EDT_SOFTWARE, core::dimension2du(800, 600));
 
+	CollectRenderer renderer( game );
 	Vector state;
+	util::Random random( 2 );
 	while(device->run())
 	{
 		float v;
@@ -132,12 +152,12 @@ int main()
 			std::lock_guard<std::mutex> lck(mTargetNet);
 			game.getCurrentState(state);
 			Action ac = qlearn::getAction(graph, state);
-			if(rand() % 100 < 5)
-				ac.id = rand() % game.getNumInputs();
+			if(random.bernoulli(0.05f))
+				ac.id = random.uniform_int(game.getNumInputs());
 			game.step(ac.id);
 		}
 		device->getVideoDriver()->beginScene();
-		game.visualize(*device->getVideoDriver(), core::recti(10, 10, 300, 300));
+		renderer.draw(*device->getVideoDriver(), core::recti(10, 10, 300, 300));
 		device->getVideoDriver()->endScene();
 		device->sleep(20);
 	}
@@ -1,44 +1,54 @@
 #include "collect.h"
-#include <irrlicht/irrlicht.h>
 #include <iostream>
 
-const float RADIUS = 0.04;
-const float SENSOR_ANGLE_DIFF = 0.3;
-const float ROTATION_SPEED = 0.07;
-const int NUM_EYES_DIR = 4;
+using namespace collect;
 
-// helper functions
-float hitTest( float sx, float sy, float a, const Object& o );
-float hitTest( float sx, float sy, float a, const std::vector<Object>& obs, int filter );
+const int GRID_CELLS = 8;
+// with more objects than this, the sensors only test the objects along each ray
+const std::size_t GRID_THRESHOLD = 384;
 
+// helper functions
+float hitTest( float sx, float sy, float lx, float ly, const ObjectArrays& obs, const ObjectGrid& grid, int filter );
 
 
+Collect::Collect( std::uint64_t seed ) : mPosX( 0 ), mPosY( 0 ), mAngle( 0 ), mGrid( GRID_CELLS, RADIUS ), mRandom( seed )
+{
+	updateSensors();
+}
 
 /** @brief getNumInputs  */
 int Collect::getNumInputs() const
 {
-	return 5;
+	return NUM_ACTIONS;
 }
 
 /** @brief getCurrentState  */
 void Collect::getCurrentState(Vector& target) const
 {
-	const int size = (2*NUM_EYES_DIR+1) * 2;
+	const int size = STATE_SIZE;
 	if(target.size() < size)
 		target.resize(size);
 	
+	if( mObjects.size() <= GRID_THRESHOLD )
+	{
+		// all sensors for both object types in one pass over the objects
+		float hits[size];
+		castRays( mPosX, mPosY, mSensorX.data(), mSensorY.data(), NUM_SENSORS, mObjects, RADIUS, SENSOR_RANGE, hits );
+		for(int i = 0; i < size; ++i)
+			target[i] = hits[i];
+		return;
+	}
+	
 	int i = 0;
-	for(int d = -NUM_EYES_DIR; d <= NUM_EYES_DIR; ++d)
+	for(int s = 0; s < NUM_SENSORS; ++s)
 	{
-		float da = d * SENSOR_ANGLE_DIFF;
-		float l = hitTest(mPosX, mPosY, mAngle + da, mObjects, 0);
+		float l = hitTest(mPosX, mPosY, mSensorX[s], mSensorY[s], mObjects, mGrid, 0);
 		target[i++] = l;
 	}
 	
-	for(int d = -NUM_EYES_DIR; d <= NUM_EYES_DIR; ++d)
+	for(int s = 0; s < NUM_SENSORS; ++s)
 	{
-		float da = d * SENSOR_ANGLE_DIFF;
-		float l = hitTest(mPosX, mPosY, mAngle + da, mObjects, 1);
+		float l = hitTest(mPosX, mPosY, mSensorX[s], mSensorY[s], mObjects, mGrid, 1);
 		target[i++] = l;
 	}
 }
@@ -53,17 +63,19 @@ bool Collect::isFinished() const
 void Collect::restart()
 {
 	mAngle = 0;
-	mPosX = rand() % 100 / 100.f;
-	mPosY = rand() % 100 / 100.f;
+	mPosX = mRandom.uniform_int( 100 ) / 100.f;
+	mPosY = mRandom.uniform_int( 100 ) / 100.f;
 	
-	for(int i = 0; i < 10; ++i)
+	std::size_t first = mObjects.size();
+	mObjects.resize( first + NUM_OBJECTS );
+	for(int i = 0; i < NUM_OBJECTS; ++i)
 	{
-		Object ob;
-		ob.x = rand() % 100 / 100.f;
-		ob.y = rand() % 100 / 100.f;
-		ob.type = i % 2;
-		mObjects.push_back( ob );
+		float x = mRandom.uniform_int( 100 ) / 100.f;
+		float y = mRandom.uniform_int( 100 ) / 100.f;
+		mObjects.set( first + i, x, y, i % 2 );
 	}
+	mGrid.build( mObjects );
+	updateSensors();
 }
 
 /** @brief step  */
@@ -82,11 +94,13 @@ float Collect::step(int input)
 		mAngle -= 2*ROTATION_SPEED;
 		break;
 	}
+	updateSensors();
 	
-	float vx = std::cos(mAngle);
-	float vy = std::sin(mAngle);
-	mPosX += 0.01 * vx;
-	mPosY += 0.01 * vy;
+	// the central sensor looks straight ahead
+	float vx = mSensorX[NUM_EYES_DIR];
+	float vy = mSensorY[NUM_EYES_DIR];
+	mPosX += SPEED * vx;
+	mPosY += SPEED * vy;
 	
 	if(mPosX > 1) mPosX -= 1;
 	if(mPosY > 1) mPosY -= 1;
@@ -94,78 +108,49 @@ float Collect::step(int input)
 	if(mPosY < 0) mPosY += 1;
 	
 	float score = 0;
+	bool moved = false;
 	
-	for(auto& ob : mObjects)
+	for(std::size_t i = 0; i < mObjects.size(); ++i)
 	{
-		float dx = ob.x - mPosX;
-		float dy = ob.y - mPosY;
+		float dx = mObjects.x(i) - mPosX;
+		float dy = mObjects.y(i) - mPosY;
 		if( dx*dx + dy * dy < 4 * RADIUS * RADIUS )
 		{
-			score += ob.type == 0 ? 1 : -1;
-			ob.x = rand() % 100 / 100.f;
-			ob.y = rand() % 100 / 100.f;
+			score += mObjects.type(i) == 0 ? 1 : -1;
+			float x = mRandom.uniform_int( 100 ) / 100.f;
+			float y = mRandom.uniform_int( 100 ) / 100.f;
+			mObjects.set( i, x, y, mObjects.type(i) );
+			moved = true;
 		}
 	}
 	
+	if( moved )
+		mGrid.build( mObjects );
+	
 	return score;
 }
 
-/** @brief visualize  */
-void Collect::visualize(irr::video::IVideoDriver& driver , irr::core::recti area  ) const
+void Collect::updateSensors()
 {
-	using namespace irr;
-	float w = area.getWidth();
-	float h = area.getHeight();
-	float r = RADIUS * w;
-	driver.draw2DRectangleOutline( area );
-	driver.draw2DPolygon( core::vector2di(mPosX * w, mPosY * h) + area.UpperLeftCorner, r );
-	for(const auto& ob : mObjects)
-	{
-		video::SColor col = ob.type == 1 ? video::SColor(255, 180, 0, 0) : video::SColor(255, 0, 180, 0);
-		driver.draw2DPolygon( core::vector2di(ob.x * w, ob.y * h) + area.UpperLeftCorner, r, col );
-	}
-	
 	for(int d = -NUM_EYES_DIR; d <= NUM_EYES_DIR; ++d)
 	{
-		float da = d * SENSOR_ANGLE_DIFF;
-		auto start = core::vector2di(mPosX * w, mPosY * h) + area.UpperLeftCorner;
-		float l = hitTest(mPosX, mPosY, mAngle + da, mObjects, -1);
-		driver.draw2DLine( start, start + core::vector2di(w * std::cos(mAngle + da) * l, w * std::sin(mAngle + da) * l)  );
+		float a = mAngle + d * SENSOR_ANGLE_DIFF;
+		mSensorX[d + NUM_EYES_DIR] = std::cos(a);
+		mSensorY[d + NUM_EYES_DIR] = std::sin(a);
 	}
 }
 
-
-// ----------------------------------------------------------------------------------
-float hitTest( float sx, float sy, float a, const Object& o )
+float Collect::getSensorHit( int s ) const
 {
-	float dx = sx - o.x;
-	float dy = sy - o.y;
-	float lx = std::cos(a);
-	float ly = std::sin(a);
-	
-	float ld = lx*dx + ly * dy;
-	float d = dx*dx+dy*dy - RADIUS*RADIUS;
-	float D = ld*ld - d;
-	if( D < 0)		return 1e12;
-	
-	float i1 = -ld - std::sqrt(D);
-	float i2 = -ld + std::sqrt(D);
-	if( i1 > 0 )	return i1;
-	if( i2 > 0 )	return i2;
-	
-	return 1e12;
+	return hitTest(mPosX, mPosY, mSensorX[s], mSensorY[s], mObjects, mGrid, -1);
 }
 
-float hitTest( float sx, float sy, float a, const std::vector<Object>& obs, int filter )
+// ----------------------------------------------------------------------------------
+float hitTest( float sx, float sy, float lx, float ly, const ObjectArrays& obs, const ObjectGrid& grid, int filter )
 {
-	float hit = 0.3;
-	for(auto& ob : obs )
+	return grid.cast( sx, sy, lx, ly, SENSOR_RANGE, [&]( int index )
 	{
-		if(filter != -1 && ob.type != filter) continue;
-		float h = hitTest(sx, sy, a, ob);
-		if(h < hit)
-			hit = h;
-	}
-	return hit;
+		if(filter != -1 && obs.type(index) != filter) return SENSOR_RANGE;
+		return hitTest(sx, sy, lx, ly, obs.x(index), obs.y(index), RADIUS);
+	});
 }
-
@@ -1,32 +1,51 @@
 #ifndef COLLECT_H_INCLUDED
 #define COLLECT_H_INCLUDED
 
+#include <array>
 #include <vector>
 #include "game.h"
-
-struct Object 
-{
-	float x;
-	float y;
-	int type;
-};
+#include "collect_params.h"
+#include "object_grid.h"
+#include "ray_cast.h"
+#include "util/random.hpp"
 
 class Collect : public Game
 {
 public:
+	// games with the same seed place the agent and the objects identically.
+	explicit Collect( std::uint64_t seed = 0 );
+	
 	int getNumInputs() const override;
 	void getCurrentState( Vector& target ) const override;
 	bool isFinished() const override;
 	void restart() override;
 	float step(int input) override;
-	void visualize( irr::video::IVideoDriver& driver, irr::core::recti area  ) const override;
+	
+	// read access for rendering
+	float getX() const { return mPosX; }
+	float getY() const { return mPosY; }
+	const ObjectArrays& getObjects() const { return mObjects; }
+	// unit direction of sensor s
+	float getSensorX( int s ) const { return mSensorX[s]; }
+	float getSensorY( int s ) const { return mSensorY[s]; }
+	// distance along sensor s to the closest object of any type
+	float getSensorHit( int s ) const;
 private:
+	// recalculates the sensor directions after mAngle changed
+	void updateSensors();
+	
 	// game state
 	float mPosX;
 	float mPosY;
 	float mAngle;
 	
-	std::vector<Object> mObjects;
+	ObjectArrays mObjects;
+	ObjectGrid mGrid;
+	util::Random mRandom;
+	
+	// unit direction vectors of the sensor rays, for the current angle
+	std::array<float, collect::NUM_SENSORS> mSensorX;
+	std::array<float, collect::NUM_SENSORS> mSensorY;
 };
 
 
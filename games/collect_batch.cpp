@@ -0,0 +1,126 @@
+#include "collect_batch.h"
+#include "util/random.hpp"
+#include <cassert>
+
+using namespace collect;
+
+namespace
+{
+	// change of the angle for each action, as in Collect::step
+	const float TURN[NUM_ACTIONS] = {0, 3 * ROTATION_SPEED, 2 * ROTATION_SPEED, -3 * ROTATION_SPEED, -2 * ROTATION_SPEED};
+}
+
+CollectBatch::CollectBatch( std::size_t count, std::uint64_t seed ) :
+	mKeys( count ), mCounters( count, 0 ),
+	mPosX( count ), mPosY( count ), mAngle( count ),
+	mSensorX( NUM_SENSORS, count ), mSensorY( NUM_SENSORS, count ),
+	mObjects( count )
+{
+	for(std::size_t i = 0; i < count; ++i)
+		mKeys[i] = util::stream_key( seed, i );
+	restart();
+}
+
+float CollectBatch::randomCoordinate( std::size_t game )
+{
+	// the random number is a hash of key and counter, so games are independent of each other
+	std::uint64_t bits = util::counter_random( mKeys[game], mCounters[game]++ );
+	return bits % 100 / 100.f;
+}
+
+void CollectBatch::restart()
+{
+	for(std::size_t i = 0; i < size(); ++i)
+		restart( i );
+}
+
+void CollectBatch::restart( std::size_t game )
+{
+	mAngle[game] = 0;
+	mPosX[game] = randomCoordinate( game );
+	mPosY[game] = randomCoordinate( game );
+
+	ObjectArrays& objects = mObjects[game];
+	objects.resize( NUM_OBJECTS );
+	for(int i = 0; i < NUM_OBJECTS; ++i)
+	{
+		float x = randomCoordinate( game );
+		float y = randomCoordinate( game );
+		objects.set( i, x, y, i % 2 );
+	}
+	updateSensors( game, game + 1 );
+}
+
+void CollectBatch::step( const int* actions, float* rewards )
+{
+	step( actions, rewards, 0, size() );
+}
+
+void CollectBatch::step( const int* actions, float* rewards, std::size_t first, std::size_t last )
+{
+	assert( first <= last && last <= size() );
+	const std::size_t n = last - first;
+	for(std::size_t i = first; i < last; ++i)
+	{
+		assert( 0 <= actions[i] && actions[i] < NUM_ACTIONS );
+		mAngle[i] += TURN[actions[i]];
+	}
+	updateSensors( first, last );
+
+	// move straight ahead, i.e. in the direction of the central sensor, and wrap around
+	auto x = mPosX.segment( first, n );
+	auto y = mPosY.segment( first, n );
+	x += float(SPEED) * mSensorX.row( NUM_EYES_DIR ).segment( first, n ).transpose();
+	y += float(SPEED) * mSensorY.row( NUM_EYES_DIR ).segment( first, n ).transpose();
+	x += (x < 0).cast<float>() - (x > 1).cast<float>();
+	y += (y < 0).cast<float>() - (y > 1).cast<float>();
+
+	for(std::size_t i = first; i < last; ++i)
+	{
+		float score = 0;
+		ObjectArrays& objects = mObjects[i];
+		for(std::size_t o = 0; o < objects.size(); ++o)
+		{
+			float dx = objects.x(o) - mPosX[i];
+			float dy = objects.y(o) - mPosY[i];
+			if( dx*dx + dy*dy < 4 * RADIUS * RADIUS )
+			{
+				score += objects.type(o) == 0 ? 1 : -1;
+				float ox = randomCoordinate( i );
+				float oy = randomCoordinate( i );
+				objects.set( o, ox, oy, objects.type(o) );
+			}
+		}
+		rewards[i] = score;
+	}
+}
+
+void CollectBatch::updateSensors( std::size_t first, std::size_t last )
+{
+	const std::size_t n = last - first;
+	for(int d = -NUM_EYES_DIR; d <= NUM_EYES_DIR; ++d)
+	{
+		auto angle = (mAngle.segment( first, n ) + d * SENSOR_ANGLE_DIFF).transpose();
+		mSensorX.row( d + NUM_EYES_DIR ).segment( first, n ) = angle.cos();
+		mSensorY.row( d + NUM_EYES_DIR ).segment( first, n ) = angle.sin();
+	}
+}
+
+void CollectBatch::getStates( Matrix& states ) const
+{
+	if( states.rows() != STATE_SIZE || states.cols() != (int)size() )
+		states.resize( STATE_SIZE, size() );
+	getStates( states, 0, size() );
+}
+
+void CollectBatch::getStates( Matrix& states, std::size_t first, std::size_t last ) const
+{
+	assert( states.rows() == STATE_SIZE && states.cols() == (int)size() );
+	for(std::size_t i = first; i < last; ++i)
+	{
+		Eigen::Matrix<float, STATE_SIZE, 1> hits;
+		castRays( mPosX[i], mPosY[i], mSensorX.col(i).data(), mSensorY.col(i).data(), NUM_SENSORS,
+				  mObjects[i], RADIUS, SENSOR_RANGE, hits.data() );
+		states.col(i) = hits.cast<number_t>();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "config.h"
+#include "collect_params.h"
+#include "ray_cast.h"
+#include <cstdint>
+#include <vector>
+
+/*! \class CollectBatch
+	\brief Simulates a batch of independent Collect games with the same rules as Collect.
+	\details The agents are stored as structure of arrays and moved together. step() and getStates()
+			work on all games at once, and the observations are written as columns of a single matrix
+			that can directly be fed to a batched forward pass.
+			Each game draws its random numbers from its own counter based generator, keyed by the seed
+			and the index of the game. Thus a game does not depend on the batch size or on the order
+			in which the games are simulated, and disjoint ranges of games can be stepped by
+			different threads.
+*/
+class CollectBatch
+{
+public:
+	CollectBatch( std::size_t count, std::uint64_t seed );
+
+	std::size_t size() const { return mPosX.size(); }
+	int getNumInputs() const { return collect::NUM_ACTIONS; }
+	int getStateSize() const { return collect::STATE_SIZE; }
+
+	// restarts all games
+	void restart();
+	void restart( std::size_t game );
+
+	// performs actions[i] in game i and writes the reward to rewards[i], for all games
+	void step( const int* actions, float* rewards );
+	// the same for the games in [first, last)
+	void step( const int* actions, float* rewards, std::size_t first, std::size_t last );
+
+	// writes the state of game i to column i of states. states is resized to getStateSize() x size() if necessary.
+	void getStates( Matrix& states ) const;
+	// the same for the games in [first, last). states has to have the correct size already.
+	void getStates( Matrix& states, std::size_t first, std::size_t last ) const;
+
+	float getX( std::size_t game ) const { return mPosX[game]; }
+	float getY( std::size_t game ) const { return mPosY[game]; }
+	float getAngle( std::size_t game ) const { return mAngle[game]; }
+	const ObjectArrays& getObjects( std::size_t game ) const { return mObjects[game]; }
+
+private:
+	// next random position coordinate of game, distributed like in Collect
+	float randomCoordinate( std::size_t game );
+	void updateSensors( std::size_t first, std::size_t last );
+
+	std::vector<std::uint64_t> mKeys;
+	std::vector<std::uint64_t> mCounters;
+
+	Eigen::ArrayXf mPosX;
+	Eigen::ArrayXf mPosY;
+	Eigen::ArrayXf mAngle;
+	// unit directions of the sensors, one column per game
+	Eigen::Array<float, collect::NUM_SENSORS, Eigen::Dynamic> mSensorX;
+	Eigen::Array<float, collect::NUM_SENSORS, Eigen::Dynamic> mSensorY;
+
+	std::vector<ObjectArrays> mObjects;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+// rules of the Collect game, shared by Collect and CollectBatch
+namespace collect
+{
+	const float RADIUS = 0.04;
+	const float SENSOR_ANGLE_DIFF = 0.3;
+	const float ROTATION_SPEED = 0.07;
+	const float SENSOR_RANGE = 0.3;
+	const double SPEED = 0.01;
+	
+	const int NUM_EYES_DIR = 4;
+	const int NUM_SENSORS = 2 * NUM_EYES_DIR + 1;
+	// distance to the closest object of each of the two types, for each sensor
+	const int STATE_SIZE = 2 * NUM_SENSORS;
+	const int NUM_ACTIONS = 5;
+	const int NUM_OBJECTS = 10;
+}
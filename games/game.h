@@ -1,23 +1,19 @@
 #pragma once
 
 #include "config.h"
-#include <irrlicht/rect.h>
-
-namespace irr
-{
-	namespace video
-	{
-		class IVideoDriver;
-	}
-}
 
+/*! \class Game
+	\brief Headless simulation interface of an environment.
+	\details Drawing is done by a separate GameRenderer (see render.h), so that games and
+			everything that trains on them do not depend on Irrlicht.
+*/
 class Game
 {
 public:
+	virtual ~Game() = default;
 	virtual int getNumInputs() const = 0;
 	virtual void getCurrentState( Vector& target ) const = 0;
 	virtual bool isFinished() const = 0;
 	virtual void restart() = 0;
 	virtual float step(int input) = 0;
-	virtual void visualize( irr::video::IVideoDriver& driver, irr::core::recti area ) const = 0;
 };
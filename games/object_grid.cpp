@@ -0,0 +1,47 @@
+#include "object_grid.h"
+#include <cassert>
+
+namespace
+{
+	// objects are inserted into slightly larger boxes, so rounding at cell borders never loses a hit
+	const float MARGIN = 1e-4;
+}
+
+ObjectGrid::ObjectGrid( int cells_per_side, float radius ) :
+	mCells( cells_per_side ), mRadius( radius + MARGIN ), mOrigin( -mRadius ),
+	mCellSize( (1 + 2 * mRadius) / cells_per_side ),
+	mCellStart( cells_per_side * cells_per_side + 1 )
+{
+	assert( cells_per_side > 0 );
+}
+
+void ObjectGrid::build( const ObjectArrays& objects )
+{
+	// counting sort of the objects into the cells: count, prefix sum, fill.
+	std::fill( mCellStart.begin(), mCellStart.end(), 0 );
+	auto for_each_cell = [&]( std::size_t i, auto&& f )
+	{
+		float ox = objects.x(i);
+		float oy = objects.y(i);
+		for(int y = cell( oy - mRadius ); y <= cell( oy + mRadius ); ++y)
+			for(int x = cell( ox - mRadius ); x <= cell( ox + mRadius ); ++x)
+				f( y * mCells + x );
+	};
+
+	for(std::size_t i = 0; i < objects.size(); ++i)
+		for_each_cell( i, [&]( int c ) { ++mCellStart[c + 1]; } );
+
+	for(std::size_t c = 1; c < mCellStart.size(); ++c)
+		mCellStart[c] += mCellStart[c - 1];
+
+	mObjects.resize( mCellStart.back() );
+	for(std::size_t i = 0; i < objects.size(); ++i)
+	{
+		// mCellStart[c] serves as insertion cursor of cell c, and ends up as its end.
+		for_each_cell( i, [&]( int c ) { mObjects[mCellStart[c]++] = i; } );
+	}
+	// the end of cell c - 1 is the start of cell c
+	for(std::size_t c = mCellStart.size() - 1; c > 0; --c)
+		mCellStart[c] = mCellStart[c - 1];
+	mCellStart[0] = 0;
+}
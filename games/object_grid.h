@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "ray_cast.h"
+
+/*! \class ObjectGrid
+	\brief Uniform grid over the unit square, that lists for each cell the objects whose circle overlaps it.
+	\details The grid is extended by the radius on each side, so that it also covers the parts of
+			circles that stick out of the unit square. Used to restrict ray casts to the objects close to the ray: cast() walks the cells along
+			the ray in order and stops as soon as the remaining cells cannot contain a closer hit.
+			The grid has to be rebuilt whenever an object moves. Rebuilding does not allocate once
+			the grid has seen the same number of objects.
+*/
+class ObjectGrid
+{
+public:
+	ObjectGrid( int cells_per_side, float radius );
+
+	void build( const ObjectArrays& objects );
+
+	/*! \brief Minimum of hit(index) over all objects that could be hit by the ray from (sx, sy) in the
+			unit direction (lx, ly) closer than max_dist, or max_dist if no such object is closer.
+		\details hit(index) has to return the distance along the ray to the circle of object index.
+				It may be called more than once for the same object.
+	*/
+	template<class F>
+	float cast( float sx, float sy, float lx, float ly, float max_dist, F&& hit ) const;
+
+private:
+	int cell( float coord ) const;
+
+	int mCells;
+	float mRadius;
+	float mOrigin;		// coordinate of the lower grid border
+	float mCellSize;
+
+	// objects of cell (x, y) are mObjects[mCellStart[i]] ... mObjects[mCellStart[i+1]-1], i = y * mCells + x
+	std::vector<int> mCellStart;
+	std::vector<int> mObjects;
+};
+
+inline int ObjectGrid::cell( float coord ) const
+{
+	return std::min( std::max( int((coord - mOrigin) / mCellSize), 0 ), mCells - 1 );
+}
+
+template<class F>
+float ObjectGrid::cast( float sx, float sy, float lx, float ly, float max_dist, F&& hit ) const
+{
+	const float INF = 1e12;
+	int cx = cell( sx );
+	int cy = cell( sy );
+	int step_x = lx > 0 ? 1 : -1;
+	int step_y = ly > 0 ? 1 : -1;
+
+	// distance along the ray to the next vertical / horizontal cell border, and between two borders
+	float next_x = lx != 0 ? (mOrigin + (cx + (lx > 0)) * mCellSize - sx) / lx : INF;
+	float next_y = ly != 0 ? (mOrigin + (cy + (ly > 0)) * mCellSize - sy) / ly : INF;
+	float delta_x = lx != 0 ? mCellSize / std::abs(lx) : INF;
+	float delta_y = ly != 0 ? mCellSize / std::abs(ly) : INF;
+
+	float best = max_dist;
+	while( true )
+	{
+		int c = cy * mCells + cx;
+		for(int i = mCellStart[c]; i < mCellStart[c+1]; ++i)
+			best = std::min( best, hit( mObjects[i] ) );
+
+		// any hit in the following cells is at least this far away
+		if( std::min( next_x, next_y ) >= best )
+			break;
+
+		if( next_x < next_y )
+		{
+			cx += step_x;
+			next_x += delta_x;
+		} else
+		{
+			cy += step_y;
+			next_y += delta_y;
+		}
+
+		// no objects outside of the grid
+		if( cx < 0 || cy < 0 || cx >= mCells || cy >= mCells )
+			break;
+	}
+	return best;
+}
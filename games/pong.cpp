@@ -0,0 +1,84 @@
+#include "pong.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace pong;
+
+Pong::Pong( bool has_vy, std::uint64_t seed ) : mHasVy( has_vy ), mRandom( seed )
+{
+	restart();
+}
+
+/** @brief getNumInputs  */
+int Pong::getNumInputs() const
+{
+	return NUM_ACTIONS;
+}
+
+/** @brief getCurrentState  */
+void Pong::getCurrentState(Vector& target) const
+{
+	if(target.size() != STATE_SIZE)
+		target.resize(STATE_SIZE);
+	
+	target.setZero();
+	target[bin(mBally)] = 1;
+	target[STATE_STEPS + bin(mPosy)] = 1;
+}
+
+/** @brief isFinished  */
+bool Pong::isFinished() const
+{
+	return mBallx >= 1.0;
+}
+
+/** @brief restart  */
+void Pong::restart()
+{
+	mBallx = START_X;
+	mBally = mRandom.uniform_int( 101 ) / 100.f;
+	mBvy = mHasVy ? (int(mRandom.uniform_int( 101 )) - 50) / 20.f : 0;
+	mPosy = mRandom.uniform_int( 101 ) / 100.f;
+}
+
+/** @brief step  */
+float Pong::step(int input)
+{
+	mBallx += BALL_SPEED;
+	mBally += BALL_SPEED*mBvy;
+
+	if( input == 1 )
+		mPosy += BAT_SPEED;
+	else if( input == 2 )
+		mPosy -= BAT_SPEED;
+
+	if(mBally > 1)
+	{
+		mBally = 2 - mBally;
+		mBvy *= -1;
+	}
+
+	if(mBally < 0)
+	{
+		mBally = -mBally;
+		mBvy *= -1;
+	}
+
+	if( mBallx >= 1.0 )
+	{
+		if( std::abs(mBally - mPosy) < BAT_SIZE )
+			return 1;
+		else
+			return -1;
+	}
+
+	return 0;
+}
+
+void Pong::setState( float ball_x, float ball_y, float ball_vy, float bat_y )
+{
+	mBallx = ball_x;
+	mBally = ball_y;
+	mBvy = ball_vy;
+	mPosy = bat_y;
+}
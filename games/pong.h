@@ -1,24 +1,44 @@
 #pragma once
 
 #include "game.h"
+#include "pong_params.h"
+#include "util/random.hpp"
 
+/*! \class Pong
+	\brief Single player pong: the ball flies towards the bat, which has to be moved into its path.
+	\details The state is a one-hot encoding of the vertical ball and bat positions, each discretized
+			into pong::STATE_STEPS bins. The actions are 0: stay, 1: up, 2: down. A game ends when the ball
+			reaches the bat, which gives a reward of +1 for a hit and -1 for a miss. PongBatch simulates
+			many games with the same rules.
+*/
 class Pong : public Game
 {
 public:
+	// if has_vy is set, the ball starts with a random vertical velocity.
+	// games with the same seed start identically.
+	explicit Pong( bool has_vy = false, std::uint64_t seed = 0 );
+	
 	int getNumInputs() const override;
 	void getCurrentState( Vector& target ) const override;
 	bool isFinished() const override;
 	void restart() override;
-	void step(int input) override;
-	void visualize( IVideoDriver& driver ) const override;
+	float step(int input) override;
+	
+	// places ball and bat, e.g. to probe the learned policy over all positions.
+	void setState( float ball_x, float ball_y, float ball_vy, float bat_y );
+	
+	float getBallX() const { return mBallx; }
+	float getBallY() const { return mBally; }
+	float getBallVY() const { return mBvy; }
+	float getBatY() const { return mPosy; }
 private:
 	// game state
 	float mBallx;
 	float mBally;
-	float mBvx;
 	float mBvy;
 	float mPosy;
 	
 	// game config
 	bool mHasVy;
+	util::Random mRandom;
 };
@@ -0,0 +1,97 @@
+#include "pong_batch.h"
+#include "util/random.hpp"
+#include <cassert>
+
+using namespace pong;
+
+namespace
+{
+	// movement of the bat for each action, as in Pong::step
+	const double BAT_MOVE[NUM_ACTIONS] = {0, BAT_SPEED, -BAT_SPEED};
+}
+
+PongBatch::PongBatch( std::size_t count, std::uint64_t seed, bool has_vy ) :
+	mKeys( count ), mCounters( count, 0 ), mHasVy( has_vy ),
+	mBallX( count ), mBallY( count ), mBallVY( count ), mBatY( count )
+{
+	for(std::size_t i = 0; i < count; ++i)
+		mKeys[i] = util::stream_key( seed, i );
+	restart();
+}
+
+int PongBatch::random( std::size_t game, int modulus )
+{
+	return util::counter_random( mKeys[game], mCounters[game]++ ) % modulus;
+}
+
+void PongBatch::restart()
+{
+	for(std::size_t i = 0; i < size(); ++i)
+		restart( i );
+}
+
+void PongBatch::restart( std::size_t game )
+{
+	// same distributions as Pong::restart
+	mBallX[game] = START_X;
+	mBallY[game] = random( game, 101 ) / 100.f;
+	mBallVY[game] = mHasVy ? (random( game, 101 ) - 50) / 20.f : 0;
+	mBatY[game] = random( game, 101 ) / 100.f;
+}
+
+void PongBatch::step( const int* actions, float* rewards )
+{
+	step( actions, rewards, 0, size() );
+}
+
+void PongBatch::step( const int* actions, float* rewards, std::size_t first, std::size_t last )
+{
+	assert( first <= last && last <= size() );
+	const std::size_t n = last - first;
+	for(std::size_t i = first; i < last; ++i)
+	{
+		assert( 0 <= actions[i] && actions[i] < NUM_ACTIONS );
+		mBatY[i] += BAT_MOVE[actions[i]];
+	}
+
+	// Pong computes the movement in double precision, do the same to get identical games
+	auto x = mBallX.segment( first, n );
+	auto y = mBallY.segment( first, n );
+	auto vy = mBallVY.segment( first, n );
+	x = (x.cast<double>() + BALL_SPEED).cast<float>();
+	y = (y.cast<double>() + BALL_SPEED * vy.cast<double>()).cast<float>();
+
+	// reflect at the upper and lower wall
+	vy = (y > 1).select( -vy, vy );
+	y = (y > 1).select( 2.f - y, y );
+	vy = (y < 0).select( -vy, vy );
+	y = (y < 0).select( -y, y );
+
+	Eigen::Map<Eigen::ArrayXf> reward( rewards + first, n );
+	auto hit = ((y - mBatY.segment( first, n )).abs() < BAT_SIZE).cast<float>();
+	reward = (x >= 1).cast<float>() * (2.f * hit - 1.f);
+
+	for(std::size_t i = first; i < last; ++i)
+	{
+		if( rewards[i] != 0 )
+			restart( i );
+	}
+}
+
+void PongBatch::getStates( Matrix& states ) const
+{
+	if( states.rows() != STATE_SIZE || states.cols() != (int)size() )
+		states.resize( STATE_SIZE, size() );
+	getStates( states, 0, size() );
+}
+
+void PongBatch::getStates( Matrix& states, std::size_t first, std::size_t last ) const
+{
+	assert( states.rows() == STATE_SIZE && states.cols() == (int)size() );
+	states.middleCols( first, last - first ).setZero();
+	for(std::size_t i = first; i < last; ++i)
+	{
+		states( bin( mBallY[i] ), i ) = 1;
+		states( STATE_STEPS + bin( mBatY[i] ), i ) = 1;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "config.h"
+#include "pong_params.h"
+#include <cstdint>
+#include <vector>
+
+/*! \class PongBatch
+	\brief Simulates a batch of independent Pong games with the same rules as Pong.
+	\details The games are stored as structure of arrays and all of them are stepped together.
+			A game ends exactly when it gives a non-zero reward, and is restarted at the end of
+			that step, so getStates() always returns the states of running games.
+			As in CollectBatch, each game draws its random numbers from its own counter based
+			generator, so a game does not depend on the batch size or on the order in which the
+			games are simulated.
+*/
+class PongBatch
+{
+public:
+	// if has_vy is set, the balls start with a random vertical velocity.
+	PongBatch( std::size_t count, std::uint64_t seed, bool has_vy = false );
+
+	std::size_t size() const { return mBallX.size(); }
+	int getNumInputs() const { return pong::NUM_ACTIONS; }
+	int getStateSize() const { return pong::STATE_SIZE; }
+
+	// restarts all games
+	void restart();
+	void restart( std::size_t game );
+
+	// performs actions[i] in game i and writes the reward to rewards[i], for all games
+	void step( const int* actions, float* rewards );
+	// the same for the games in [first, last)
+	void step( const int* actions, float* rewards, std::size_t first, std::size_t last );
+
+	// writes the state of game i to column i of states. states is resized to getStateSize() x size() if necessary.
+	void getStates( Matrix& states ) const;
+	// the same for the games in [first, last). states has to have the correct size already.
+	void getStates( Matrix& states, std::size_t first, std::size_t last ) const;
+
+	float getBallX( std::size_t game ) const { return mBallX[game]; }
+	float getBallY( std::size_t game ) const { return mBallY[game]; }
+	float getBallVY( std::size_t game ) const { return mBallVY[game]; }
+	float getBatY( std::size_t game ) const { return mBatY[game]; }
+
+private:
+	// next random number in [0, modulus) of game
+	int random( std::size_t game, int modulus );
+
+	std::vector<std::uint64_t> mKeys;
+	std::vector<std::uint64_t> mCounters;
+	bool mHasVy;
+
+	Eigen::ArrayXf mBallX;
+	Eigen::ArrayXf mBallY;
+	Eigen::ArrayXf mBallVY;
+	Eigen::ArrayXf mBatY;
+};
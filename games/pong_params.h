@@ -0,0 +1,23 @@
+#pragma once
+
+// rules of the Pong game, shared by Pong and PongBatch
+namespace pong
+{
+	const float BAT_SIZE = 0.05;
+	const double BALL_SPEED = 0.01;
+	const double BAT_SPEED = 0.025;
+	const float START_X = 0.6;
+
+	// number of bins of the one-hot encoding of the ball and the bat position
+	const int STATE_STEPS = 15;
+	const int STATE_SIZE = 2 * STATE_STEPS;
+	// 0: stay, 1: up, 2: down
+	const int NUM_ACTIONS = 3;
+
+	// bin of the one-hot encoding of a position in [0, 1]
+	inline int bin( float pos )
+	{
+		int b = int(STATE_STEPS * pos);
+		return b < 0 ? 0 : (b >= STATE_STEPS ? STATE_STEPS - 1 : b);
+	}
+}
@@ -0,0 +1,105 @@
+#include "ray_cast.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	// position of the padding objects
+	const float FAR_AWAY = 1e6;
+}
+
+void ObjectArrays::resize( std::size_t count )
+{
+	std::size_t padded = (count + BLOCK - 1) / BLOCK * BLOCK;
+	mX.resize( padded, FAR_AWAY );
+	mY.resize( padded, FAR_AWAY );
+	mType.resize( padded, -1 );
+	// objects that were removed become padding
+	for(std::size_t i = count; i < mCount && i < padded; ++i)
+		set( i, FAR_AWAY, FAR_AWAY, -1 );
+	mCount = count;
+}
+
+void ObjectArrays::set( std::size_t i, float x, float y, int type )
+{
+	assert( i < mX.size() );
+	mX[i] = x;
+	mY[i] = y;
+	mType[i] = type;
+}
+
+void castRays( float sx, float sy, const float* dir_x, const float* dir_y, int n,
+			   const ObjectArrays& objects, float radius, float max_dist, float* hits )
+{
+	const std::size_t BLOCK = ObjectArrays::BLOCK;
+	assert( n <= MAX_RAYS );
+
+	// closest hit per lane, for each type and ray
+	alignas(64) float best[2][MAX_RAYS][BLOCK];
+	std::fill( &best[0][0][0], &best[0][0][0] + 2 * MAX_RAYS * BLOCK, max_dist );
+
+	const float r2 = radius * radius;
+	for(std::size_t b = 0; b < objects.padded_size(); b += BLOCK)
+	{
+		const float* ox = objects.x_data() + b;
+		const float* oy = objects.y_data() + b;
+		const int* ot = objects.type_data() + b;
+
+		// the ray independent part, shared by all rays
+		alignas(64) float dx[BLOCK];
+		alignas(64) float dy[BLOCK];
+		alignas(64) float c[BLOCK];
+		for(std::size_t k = 0; k < BLOCK; ++k)
+		{
+			dx[k] = sx - ox[k];
+			dy[k] = sy - oy[k];
+			c[k] = dx[k]*dx[k] + dy[k]*dy[k] - r2;
+		}
+
+		for(int r = 0; r < n; ++r)
+		{
+			const float lx = dir_x[r];
+			const float ly = dir_y[r];
+			float* best0 = best[0][r];
+			float* best1 = best[1][r];
+			for(std::size_t k = 0; k < BLOCK; ++k)
+			{
+				float ld = lx*dx[k] + ly*dy[k];
+				float D = ld*ld - c[k];
+				float s = std::sqrt( std::max( D, 0.f ) );
+				// first intersection in front of the start, as in hitTest
+				float h = -ld - s > 0 ? -ld - s : -ld + s;
+				h = (D >= 0) & (h > 0) ? h : max_dist;
+				float h0 = ot[k] == 0 ? h : max_dist;
+				float h1 = ot[k] == 1 ? h : max_dist;
+				best0[k] = std::min( best0[k], h0 );
+				best1[k] = std::min( best1[k], h1 );
+			}
+		}
+	}
+
+	for(int t = 0; t < 2; ++t)
+	{
+		for(int r = 0; r < n; ++r)
+			hits[t * n + r] = *std::min_element( best[t][r], best[t][r] + BLOCK );
+	}
+}
+
+float hitTest( float sx, float sy, float lx, float ly, float ox, float oy, float radius )
+{
+	float dx = sx - ox;
+	float dy = sy - oy;
+	
+	float ld = lx*dx + ly * dy;
+	float d = dx*dx+dy*dy - radius*radius;
+	float D = ld*ld - d;
+	if( D < 0)		return 1e12;
+	
+	float i1 = -ld - std::sqrt(D);
+	float i2 = -ld + std::sqrt(D);
+	if( i1 > 0 )	return i1;
+	if( i2 > 0 )	return i2;
+	
+	return 1e12;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*! \class ObjectArrays
+	\brief Positions and types of circular objects, stored as structure of arrays.
+	\details The arrays are padded to a multiple of BLOCK with objects of type -1 that are never
+			reported as hits, so that castRays can always work on full blocks.
+*/
+class ObjectArrays
+{
+public:
+	static const std::size_t BLOCK = 16;
+
+	// resizes to count objects. New objects are padding until they are set.
+	void resize( std::size_t count );
+	std::size_t size() const { return mCount; }
+	// number of objects including the padding
+	std::size_t padded_size() const { return mX.size(); }
+
+	void set( std::size_t i, float x, float y, int type );
+
+	float x( std::size_t i ) const { return mX[i]; }
+	float y( std::size_t i ) const { return mY[i]; }
+	int type( std::size_t i ) const { return mType[i]; }
+
+	const float* x_data() const { return mX.data(); }
+	const float* y_data() const { return mY.data(); }
+	const int* type_data() const { return mType.data(); }
+
+private:
+	std::size_t mCount = 0;
+	std::vector<float> mX;
+	std::vector<float> mY;
+	std::vector<int> mType;
+};
+
+// maximum number of rays that castRays handles in one pass
+const int MAX_RAYS = 16;
+
+/*! \brief Intersects n rays starting at (sx, sy) with all objects (circles of the given radius) in one pass.
+	\details The direction of ray i is the unit vector (dir_x[i], dir_y[i]). The distance along ray i
+			to the closest object of type t is written to hits[t * n + i], for the types t = 0 and 1.
+			Distances are clamped to max_dist.
+			The objects are processed in blocks of ObjectArrays::BLOCK, with branch free code that the
+			compiler turns into SIMD instructions. The distances agree with hitTest up to float rounding,
+			but are not guaranteed to be bitwise identical, as the compiler may reorder the arithmetic.
+*/
+void castRays( float sx, float sy, const float* dir_x, const float* dir_y, int n,
+			   const ObjectArrays& objects, float radius, float max_dist, float* hits );
+
+// distance along the ray from (sx, sy) in the unit direction (lx, ly) to the circle around (ox, oy),
+// or a very large value if the ray does not hit it.
+float hitTest( float sx, float sy, float lx, float ly, float ox, float oy, float radius );
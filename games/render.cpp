@@ -0,0 +1,39 @@
+#include "render.h"
+#include "collect.h"
+#include "pong.h"
+#include <irrlicht/irrlicht.h>
+
+using namespace irr;
+
+void CollectRenderer::draw( video::IVideoDriver& driver, core::recti area ) const
+{
+	float w = area.getWidth();
+	float h = area.getHeight();
+	float r = collect::RADIUS * w;
+	auto position = core::vector2di(mGame.getX() * w, mGame.getY() * h) + area.UpperLeftCorner;
+	driver.draw2DRectangleOutline( area );
+	driver.draw2DPolygon( position, r );
+
+	const ObjectArrays& objects = mGame.getObjects();
+	for(std::size_t i = 0; i < objects.size(); ++i)
+	{
+		video::SColor col = objects.type(i) == 1 ? video::SColor(255, 180, 0, 0) : video::SColor(255, 0, 180, 0);
+		driver.draw2DPolygon( core::vector2di(objects.x(i) * w, objects.y(i) * h) + area.UpperLeftCorner, r, col );
+	}
+
+	for(int s = 0; s < collect::NUM_SENSORS; ++s)
+	{
+		float l = mGame.getSensorHit( s );
+		driver.draw2DLine( position, position + core::vector2di(w * mGame.getSensorX(s) * l, w * mGame.getSensorY(s) * l) );
+	}
+}
+
+void PongRenderer::draw( video::IVideoDriver& driver, core::recti area ) const
+{
+	float w = area.getWidth();
+	float h = area.getHeight();
+	driver.draw2DRectangleOutline( area );
+	driver.draw2DPolygon( core::vector2di(mGame.getBallX() * w, mGame.getBallY() * h) + area.UpperLeftCorner, 0.02 * w );
+	driver.draw2DLine( core::vector2di(w, (mGame.getBatY() - pong::BAT_SIZE) * h) + area.UpperLeftCorner,
+					   core::vector2di(w, (mGame.getBatY() + pong::BAT_SIZE) * h) + area.UpperLeftCorner );
+}
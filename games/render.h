@@ -0,0 +1,45 @@
+#pragma once
+
+#include <irrlicht/rect.h>
+
+namespace irr
+{
+	namespace video
+	{
+		class IVideoDriver;
+	}
+}
+
+class Collect;
+class Pong;
+
+/*! \class GameRenderer
+	\brief Draws the current state of a game with Irrlicht.
+	\details Rendering is an optional adapter on top of the headless Game interface. Only programs
+			that show a game need to compile render.cpp and link Irrlicht. A renderer keeps a reference
+			to its game, which has to outlive it.
+*/
+class GameRenderer
+{
+public:
+	virtual ~GameRenderer() = default;
+	virtual void draw( irr::video::IVideoDriver& driver, irr::core::recti area ) const = 0;
+};
+
+class CollectRenderer final : public GameRenderer
+{
+public:
+	explicit CollectRenderer( const Collect& game ) : mGame( game ) {}
+	void draw( irr::video::IVideoDriver& driver, irr::core::recti area ) const override;
+private:
+	const Collect& mGame;
+};
+
+class PongRenderer final : public GameRenderer
+{
+public:
+	explicit PongRenderer( const Pong& game ) : mGame( game ) {}
+	void draw( irr::video::IVideoDriver& driver, irr::core::recti area ) const override;
+private:
+	const Pong& mGame;
+};
@@ -0,0 +1,36 @@
+#include "branch_layer.hpp"
+#include <stdexcept>
+
+namespace net
+{
+IBranchLayer::IBranchLayer( std::vector<Network> branches ) : mBranches( std::move(branches) )
+{
+}
+
+void IBranchLayer::backward(const Vector& error, Vector& back, const ComputationNode& compute, Solver& solver) const
+{
+	throw std::logic_error("branching layers can only be trained through a ComputationGraph");
+}
+
+void IBranchLayer::update(Solver& solver)
+{
+	for(auto& branch : mBranches)
+	{
+		branch.update( solver );
+	}
+}
+
+void IBranchLayer::getParameters( std::vector<Matrix*>& params )
+{
+	for(auto& branch : mBranches)
+	{
+		const auto& branch_params = branch.getParameters();
+		params.insert( params.end(), branch_params.begin(), branch_params.end() );
+	}
+}
+
+void IBranchLayer::process(const Vector& input, Vector& output) const
+{
+	throw std::logic_error("branching layers can only be evaluated through a ComputationGraph");
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "layer.hpp"
+#include "network.hpp"
+#include <vector>
+
+namespace net
+{
+/*! \class IBranchLayer
+	\brief Layer that passes its input through several sub-networks and merges their results.
+	\details The branches are not evaluated by the layer itself, but expanded by the ComputationGraph,
+			which takes care of sharing the input node and of combining the errors of all branches.
+*/
+class IBranchLayer : public ILayer
+{
+public:
+	explicit IBranchLayer( std::vector<Network> branches );
+	
+	/// get the sub-networks that all receive the input of this layer.
+	const std::vector<Network>& getBranches() const { return mBranches; }
+	
+	/// combines the outputs of all branches into the output of the layer.
+	virtual void merge( const std::vector<const Vector*>& branches, Vector& out ) const = 0;
+	
+	/// splits the error with respect to the layer output into the errors of the branches.
+	virtual void split( const Vector& error, std::vector<Vector>& branch_errors ) const = 0;
+	
+	/// branches are trained by the ComputationGraph, so this throws std::logic_error.
+	void backward(const Vector& error, Vector& back, const ComputationNode& compute, Solver& solver) const final;
+	
+	/// updates all branches.
+	void update(Solver& solver) final;
+	
+	/// parameters of all branches, in order.
+	void getParameters( std::vector<Matrix*>& params ) final;
+	
+protected:
+	std::vector<Network> mBranches;
+	
+private:
+	/// branches are evaluated by the ComputationGraph, so this throws std::logic_error.
+	void process(const Vector& input, Vector& output) const final;
+};
+}
@@ -0,0 +1,383 @@
+#include "checkpoint.hpp"
+#include "network.hpp"
+#include "branch_layer.hpp"
+#include "dueling_layer.hpp"
+#include "fc_layer.hpp"
+#include "relu_layer.hpp"
+#include "tanh_layer.hpp"
+#include "solver.hpp"
+
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace net
+{
+namespace
+{
+	const char MAGIC[8] = {'D', 'Q', 'N', 'C', 'K', 'P', 'T', '\0'};
+	const std::uint32_t VERSION = 1;
+	const std::uint32_t ENDIAN_MARK = 0x01020304;
+	const std::size_t ALIGNMENT = 64;
+
+	struct Header
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t endian;
+		std::uint32_t scalar_size;
+		std::uint32_t reserved;
+		std::uint64_t file_size;
+		std::uint64_t topology_offset;
+		std::uint64_t parameter_offset;
+		std::uint64_t parameter_count;
+		std::uint64_t counter_offset;
+		std::uint64_t counter_count;
+	};
+
+	// a network is stored as NetworkRecord followed by its layers. Each layer is a LayerRecord,
+	// followed by the networks of its branches.
+	struct NetworkRecord
+	{
+		std::uint64_t layer_count;
+	};
+
+	struct LayerRecord
+	{
+		char type[16];
+		std::uint64_t branch_count;
+	};
+
+	struct ParameterRecord
+	{
+		std::uint64_t rows;
+		std::uint64_t cols;
+		std::uint64_t data_offset;
+		std::uint64_t state_offset;		// zero if no optimizer state was saved
+	};
+
+	struct CounterRecord
+	{
+		char name[24];
+		std::uint64_t value;
+	};
+
+	std::size_t align( std::size_t offset )
+	{
+		return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+
+	const IBranchLayer* asBranching( const ILayer& layer )
+	{
+		return dynamic_cast<const IBranchLayer*>( &layer );
+	}
+
+	std::size_t topologySize( const Network& network )
+	{
+		std::size_t size = sizeof(NetworkRecord);
+		for(const auto& layer : network.getLayers())
+		{
+			size += sizeof(LayerRecord);
+			if( auto branching = asBranching(*layer) )
+			{
+				for(const auto& branch : branching->getBranches())
+					size += topologySize( branch );
+			}
+		}
+		return size;
+	}
+
+	char* writeTopology( const Network& network, char* out )
+	{
+		NetworkRecord net_rec{ network.getLayers().size() };
+		std::memcpy( out, &net_rec, sizeof(net_rec) );
+		out += sizeof(net_rec);
+
+		for(const auto& layer : network.getLayers())
+		{
+			auto branching = asBranching(*layer);
+			LayerRecord rec;
+			std::memset( &rec, 0, sizeof(rec) );
+			std::strncpy( rec.type, layer->getLayerType(), sizeof(rec.type) - 1 );
+			rec.branch_count = branching ? branching->getBranches().size() : 0;
+			std::memcpy( out, &rec, sizeof(rec) );
+			out += sizeof(rec);
+
+			if( branching )
+			{
+				for(const auto& branch : branching->getBranches())
+					out = writeTopology( branch, out );
+			}
+		}
+		return out;
+	}
+
+	bool hasSolverState( const Solver* solver, const Matrix& parameter )
+	{
+		return solver && solver->getUpdateRule().hasState( parameter );
+	}
+
+	std::size_t blockSize( const Matrix& m )
+	{
+		return align( m.size() * sizeof(number_t) );
+	}
+}
+
+Checkpoint::Checkpoint( const Network& network, const Solver* solver ) : mNetwork( network ), mSolver( solver )
+{
+}
+
+Checkpoint& Checkpoint::counter( const std::string& name, std::uint64_t value )
+{
+	mCounters.emplace_back( name, value );
+	return *this;
+}
+
+std::size_t Checkpoint::size() const
+{
+	const auto& params = mNetwork.getParameters();
+	std::size_t size = sizeof(Header) + topologySize( mNetwork );
+	size += params.size() * sizeof(ParameterRecord) + mCounters.size() * sizeof(CounterRecord);
+	size = align( size );
+	for(const Matrix* param : params)
+	{
+		size += blockSize( *param );
+		if( hasSolverState(mSolver, *param) )
+			size += blockSize( *param );
+	}
+	return size;
+}
+
+void Checkpoint::serialize( std::vector<char>& buffer ) const
+{
+	const auto& params = mNetwork.getParameters();
+	// assign does not reallocate if the capacity is sufficient, and zero-initializes the padding
+	buffer.assign( size(), 0 );
+	char* data = buffer.data();
+
+	Header header;
+	std::memcpy( header.magic, MAGIC, sizeof(MAGIC) );
+	header.version = VERSION;
+	header.endian = ENDIAN_MARK;
+	header.scalar_size = sizeof(number_t);
+	header.reserved = 0;
+	header.file_size = buffer.size();
+	header.topology_offset = sizeof(Header);
+
+	char* topology_end = writeTopology( mNetwork, data + header.topology_offset );
+	header.parameter_offset = topology_end - data;
+	header.parameter_count = params.size();
+	header.counter_offset = header.parameter_offset + params.size() * sizeof(ParameterRecord);
+	header.counter_count = mCounters.size();
+	std::memcpy( data, &header, sizeof(header) );
+
+	std::size_t block = align( header.counter_offset + mCounters.size() * sizeof(CounterRecord) );
+	auto write_block = [&]( const Matrix& m )
+	{
+		std::size_t offset = block;
+		std::memcpy( data + offset, m.data(), m.size() * sizeof(number_t) );
+		block += blockSize( m );
+		return offset;
+	};
+
+	for(std::size_t i = 0; i < params.size(); ++i)
+	{
+		const Matrix& param = *params[i];
+		ParameterRecord rec;
+		rec.rows = param.rows();
+		rec.cols = param.cols();
+		rec.data_offset = write_block( param );
+		rec.state_offset = 0;
+		if( hasSolverState( mSolver, param ) )
+		{
+			// the rule converts its state to number_t directly into the buffer
+			Eigen::Map<Matrix> state( reinterpret_cast<number_t*>( data + block ), param.rows(), param.cols() );
+			mSolver->getUpdateRule().getState( param, state );
+			rec.state_offset = block;
+			block += blockSize( param );
+		}
+		std::memcpy( data + header.parameter_offset + i * sizeof(rec), &rec, sizeof(rec) );
+	}
+
+	for(std::size_t i = 0; i < mCounters.size(); ++i)
+	{
+		CounterRecord rec;
+		std::memset( &rec, 0, sizeof(rec) );
+		std::strncpy( rec.name, mCounters[i].first.c_str(), sizeof(rec.name) - 1 );
+		rec.value = mCounters[i].second;
+		std::memcpy( data + header.counter_offset + i * sizeof(rec), &rec, sizeof(rec) );
+	}
+}
+
+void Checkpoint::write( const std::string& path ) const
+{
+	std::vector<char> buffer;
+	serialize( buffer );
+	writeFile( path, buffer.data(), buffer.size() );
+}
+
+void writeFile( const std::string& path, const char* data, std::size_t size, bool sync )
+{
+	// write to a temporary file first, so an interrupted write never destroys an existing checkpoint
+	std::string temp = path + ".tmp";
+	int fd = ::open( temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( fd < 0 )
+		throw std::runtime_error("could not open " + temp + ": " + std::strerror(errno));
+
+	while( size > 0 )
+	{
+		ssize_t written = ::write( fd, data, size );
+		if( written < 0 )
+		{
+			if( errno == EINTR )
+				continue;
+			int error = errno;
+			::close( fd );
+			throw std::runtime_error("could not write " + temp + ": " + std::strerror(error));
+		}
+		data += written;
+		size -= written;
+	}
+
+	int error = 0;
+	if( sync && ::fsync( fd ) != 0 )
+		error = errno;
+	if( ::close( fd ) != 0 && error == 0 )
+		error = errno;
+	if( error != 0 )
+		throw std::runtime_error("could not finish writing " + temp + ": " + std::strerror(error));
+
+	if( std::rename( temp.c_str(), path.c_str() ) != 0 )
+		throw std::runtime_error("could not rename " + temp + " to " + path + ": " + std::strerror(errno));
+}
+
+// ---------------------------------------------------------------------------------------------
+MappedCheckpoint::MappedCheckpoint( const std::string& path ) : mFile( path )
+{
+	const Header& header = *at<Header>( 0 );
+	if( std::memcmp( header.magic, MAGIC, sizeof(MAGIC) ) != 0 || header.version != VERSION ||
+		header.endian != ENDIAN_MARK || header.scalar_size != sizeof(number_t) || header.file_size != mFile.size() )
+	{
+		throw std::runtime_error(path + " is not a compatible checkpoint");
+	}
+
+	mParameterCount = header.parameter_count;
+}
+
+template<class T>
+const T* MappedCheckpoint::at( std::uint64_t offset, std::uint64_t count ) const
+{
+	return mFile.at<T>( offset, count );
+}
+
+void MappedCheckpoint::checkParameter( std::size_t i ) const
+{
+	if( i >= mParameterCount )
+		throw std::out_of_range("checkpoint has no parameter " + std::to_string(i));
+}
+
+MappedCheckpoint::view_t MappedCheckpoint::getParameter( std::size_t i ) const
+{
+	checkParameter( i );
+	const Header& header = *at<Header>( 0 );
+	const auto& rec = at<ParameterRecord>( header.parameter_offset, mParameterCount )[i];
+	return view_t( at<number_t>( rec.data_offset, rec.rows * rec.cols ), rec.rows, rec.cols );
+}
+
+bool MappedCheckpoint::hasState( std::size_t i ) const
+{
+	checkParameter( i );
+	const Header& header = *at<Header>( 0 );
+	return at<ParameterRecord>( header.parameter_offset, mParameterCount )[i].state_offset != 0;
+}
+
+MappedCheckpoint::view_t MappedCheckpoint::getState( std::size_t i ) const
+{
+	checkParameter( i );
+	const Header& header = *at<Header>( 0 );
+	const auto& rec = at<ParameterRecord>( header.parameter_offset, mParameterCount )[i];
+	if( rec.state_offset == 0 )
+		throw std::out_of_range("no optimizer state saved for parameter " + std::to_string(i));
+	return view_t( at<number_t>( rec.state_offset, rec.rows * rec.cols ), rec.rows, rec.cols );
+}
+
+std::uint64_t MappedCheckpoint::getCounter( const std::string& name, std::uint64_t fallback ) const
+{
+	const Header& header = *at<Header>( 0 );
+	const CounterRecord* counters = at<CounterRecord>( header.counter_offset, header.counter_count );
+	for(std::size_t i = 0; i < header.counter_count; ++i)
+	{
+		if( name.compare( 0, sizeof(counters[i].name) - 1, counters[i].name ) == 0 )
+			return counters[i].value;
+	}
+	return fallback;
+}
+
+Network MappedCheckpoint::network() const
+{
+	std::uint64_t offset = at<Header>( 0 )->topology_offset;
+	std::size_t parameter = 0;
+	Network result = readNetwork( offset, parameter );
+	if( parameter != mParameterCount )
+		throw std::runtime_error("checkpoint topology does not match its parameters");
+	return result;
+}
+
+Network MappedCheckpoint::readNetwork( std::uint64_t& offset, std::size_t& parameter ) const
+{
+	auto next_parameter = [&]()
+	{
+		if( parameter >= mParameterCount )
+			throw std::runtime_error("checkpoint topology does not match its parameters");
+		return Matrix( getParameter( parameter++ ) );
+	};
+
+	Network network;
+	std::uint64_t layer_count = at<NetworkRecord>( offset )->layer_count;
+	offset += sizeof(NetworkRecord);
+	for(std::uint64_t l = 0; l < layer_count; ++l)
+	{
+		const LayerRecord& rec = *at<LayerRecord>( offset );
+		offset += sizeof(LayerRecord);
+		std::string type( rec.type, strnlen( rec.type, sizeof(rec.type) ) );
+
+		std::vector<Network> branches;
+		for(std::uint64_t b = 0; b < rec.branch_count; ++b)
+			branches.push_back( readNetwork( offset, parameter ) );
+
+		if( type == "fc" )
+			network << FcLayer( next_parameter() );
+		else if( type == "relu" )
+			network << ReLULayer( next_parameter() );
+		else if( type == "tanh" )
+			network << TanhLayer( next_parameter() );
+		else if( type == "dueling" && branches.size() == 2 )
+			network << DuelingHead( std::move(branches[0]), std::move(branches[1]) );
+		else
+			throw std::runtime_error("unknown layer type '" + type + "' in checkpoint");
+	}
+	return network;
+}
+
+void MappedCheckpoint::restore( Network& network, Solver* solver ) const
+{
+	const auto& params = network.getParameters();
+	if( params.size() != mParameterCount )
+		throw std::invalid_argument("network does not match checkpoint");
+	for(std::size_t i = 0; i < mParameterCount; ++i)
+	{
+		auto saved = getParameter( i );
+		if( saved.rows() != params[i]->rows() || saved.cols() != params[i]->cols() )
+			throw std::invalid_argument("network does not match checkpoint");
+	}
+
+	for(std::size_t i = 0; i < mParameterCount; ++i)
+	{
+		*params[i] = getParameter( i );
+		if( solver && hasState( i ) )
+			solver->getUpdateRule().setState( *params[i], getState( i ) );
+	}
+}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "config.h"
+#include "checkpoint_writer.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace net
+{
+	class Network;
+	class Solver;
+
+	/*! \class Checkpoint
+		\brief Binary snapshot of a Network, its optimizer state and additional counters.
+		\details The file starts with a fixed header, followed by the layer topology, a table
+				of all parameters and the counters. The parameter data and the state of the
+				update rule are stored as raw, 64 byte aligned blocks in column major order, so
+				that they can be used directly from a memory mapped file (see MappedCheckpoint).
+				The whole checkpoint is serialized into a single buffer and written with one call.
+	*/
+	class Checkpoint : public ISnapshot
+	{
+	public:
+		// solver may be nullptr, in which case no optimizer state is saved.
+		Checkpoint( const Network& network, const Solver* solver = nullptr );
+
+		// adds a named counter, e.g. the number of training steps. name is truncated to 23 characters.
+		Checkpoint& counter( const std::string& name, std::uint64_t value );
+
+		// size of the serialized checkpoint in bytes
+		std::size_t size() const;
+
+		// serializes the checkpoint into buffer. Does not allocate if buffer already has sufficient capacity.
+		void serialize( std::vector<char>& buffer ) const override;
+
+		// serializes and writes the checkpoint to path. Throws std::runtime_error on failure.
+		void write( const std::string& path ) const;
+
+	private:
+		const Network& mNetwork;
+		const Solver* mSolver;
+		std::vector<std::pair<std::string, std::uint64_t>> mCounters;
+	};
+
+	// writes size bytes of data to path with a single write call (retrying on partial writes).
+	// if sync is set, the file is fsync'ed before it is closed. Throws std::runtime_error on failure.
+	void writeFile( const std::string& path, const char* data, std::size_t size, bool sync = false );
+
+	/*! \class MappedCheckpoint
+		\brief Read access to a checkpoint file through a read-only memory mapping.
+		\details Parameter and state views point directly into the mapping, and remain valid as long as
+				this object exists. Throws std::runtime_error if the file cannot be mapped or is not a
+				valid checkpoint of this version and scalar type.
+	*/
+	class MappedCheckpoint
+	{
+	public:
+		using view_t = Eigen::Map<const Matrix>;
+
+		explicit MappedCheckpoint( const std::string& path );
+
+		std::size_t getParameterCount() const { return mParameterCount; }
+		// zero-copy view of the i'th parameter, in the order of Network::getParameters
+		view_t getParameter( std::size_t i ) const;
+		// checks whether optimizer state was saved for the i'th parameter.
+		bool hasState( std::size_t i ) const;
+		view_t getState( std::size_t i ) const;
+		// the accessors for the i'th parameter throw std::out_of_range if i >= getParameterCount().
+
+		// value of a named counter, or fallback if it is not present.
+		std::uint64_t getCounter( const std::string& name, std::uint64_t fallback = 0 ) const;
+
+		// builds a new network with the saved topology and parameters.
+		Network network() const;
+
+		// copies the saved parameters into network, which has to have the saved structure.
+		// if solver is given, the state of its update rule is restored, too.
+		// Throws std::invalid_argument if the network does not match the checkpoint.
+		void restore( Network& network, Solver* solver = nullptr ) const;
+
+	private:
+		// bounds checked access to count objects of type T at offset
+		template<class T>
+		const T* at( std::uint64_t offset, std::uint64_t count = 1 ) const;
+
+		Network readNetwork( std::uint64_t& offset, std::size_t& parameter ) const;
+		// throws std::out_of_range for an invalid parameter index
+		void checkParameter( std::size_t i ) const;
+
+		MappedFile mFile;
+		std::size_t mParameterCount = 0;
+	};
+}
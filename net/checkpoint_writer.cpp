@@ -0,0 +1,90 @@
+#include "checkpoint_writer.hpp"
+#include "checkpoint.hpp"
+#include <stdexcept>
+
+namespace net
+{
+AsyncCheckpointWriter::AsyncCheckpointWriter() : mThread( &AsyncCheckpointWriter::run, this )
+{
+}
+
+AsyncCheckpointWriter::~AsyncCheckpointWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStop = true;
+	}
+	mCondition.notify_all();
+	mThread.join();
+}
+
+bool AsyncCheckpointWriter::submit( std::initializer_list<File> files )
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	if( mPending )
+		return false;
+	
+	// the writer thread is idle, so holding the lock does not block it
+	if( mBuffers.size() < files.size() )
+		mBuffers.resize( files.size() );
+	mFileCount = 0;
+	for(const File& file : files)
+	{
+		Buffer& buffer = mBuffers[mFileCount++];
+		file.snapshot.serialize( buffer.data );
+		buffer.path = file.path;
+	}
+	mPending = true;
+	lock.unlock();
+	mCondition.notify_all();
+	return true;
+}
+
+bool AsyncCheckpointWriter::busy() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mPending;
+}
+
+void AsyncCheckpointWriter::wait()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mCondition.wait( lock, [this]() { return !mPending; } );
+}
+
+std::string AsyncCheckpointWriter::getLastError() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mError;
+}
+
+void AsyncCheckpointWriter::run()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	while( true )
+	{
+		mCondition.wait( lock, [this]() { return mPending || mStop; } );
+		if( !mPending )
+			return;
+		
+		// submit() does not touch the buffers while a write is pending
+		lock.unlock();
+		std::string error;
+		for(std::size_t i = 0; i < mFileCount && error.empty(); ++i)
+		{
+			try
+			{
+				writeFile( mBuffers[i].path, mBuffers[i].data.data(), mBuffers[i].data.size(), true );
+			} catch( std::exception& e )
+			{
+				error = e.what();
+			}
+		}
+		lock.lock();
+		
+		mError = std::move(error);
+		mPending = false;
+		mCondition.notify_all();
+	}
+}
+}
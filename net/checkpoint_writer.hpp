@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace net
+{
+	/*! \class ISnapshot
+		\brief State that can be copied into a flat buffer and written to a file later, see AsyncCheckpointWriter.
+	*/
+	class ISnapshot
+	{
+	public:
+		virtual ~ISnapshot() = default;
+		// serializes the complete file contents into buffer. Should not allocate if buffer already has
+		// sufficient capacity.
+		virtual void serialize( std::vector<char>& buffer ) const = 0;
+	};
+	
+	/*! \class AsyncCheckpointWriter
+		\brief Writes checkpoints to disk on a background thread.
+		\details submit() takes the snapshot synchronously by serializing the checkpoint, and optionally
+				further files such as the replay memory, into internal buffers. These are plain copies of
+				the parameters, optimizer state and experiences. Writing and syncing the files then happens
+				on the writer thread, so the caller only pays for the copy. The buffers are reused for all
+				checkpoints: while a write is in progress, further submissions are rejected, which bounds
+				the memory overhead to one checkpoint.
+	*/
+	class AsyncCheckpointWriter
+	{
+	public:
+		AsyncCheckpointWriter();
+		// waits for the pending write to finish.
+		~AsyncCheckpointWriter();
+		
+		AsyncCheckpointWriter( const AsyncCheckpointWriter& ) = delete;
+		AsyncCheckpointWriter& operator=( const AsyncCheckpointWriter& ) = delete;
+		
+		struct File
+		{
+			const ISnapshot& snapshot;
+			std::string path;
+		};
+		
+		// snapshots all files at once and schedules them to be written in order. Returns false, without
+		// taking a snapshot, if the previous checkpoint has not been written yet.
+		bool submit( std::initializer_list<File> files );
+		bool submit( const ISnapshot& snapshot, const std::string& path ) { return submit( {File{snapshot, path}} ); }
+		
+		// checks whether a checkpoint is currently being written.
+		bool busy() const;
+		
+		// blocks until the pending checkpoint has been written.
+		void wait();
+		
+		// error message of the last failed write, or empty string if it succeeded.
+		std::string getLastError() const;
+		
+	private:
+		void run();
+		
+		mutable std::mutex mMutex;
+		std::condition_variable mCondition;
+		
+		struct Buffer
+		{
+			std::vector<char> data;
+			std::string path;
+		};
+		// only the first mFileCount buffers belong to the pending checkpoint
+		std::vector<Buffer> mBuffers;
+		std::size_t mFileCount = 0;
+		std::string mError;
+		bool mPending = false;
+		bool mStop = false;
+		
+		std::thread mThread;
+	};
+}
@@ -1,15 +1,46 @@
 #include "computation_graph.hpp"
 #include "computation_node.hpp"
+#include "branch_layer.hpp"
 #include "network.hpp"
+#include "util/trace.hpp"
 
 namespace net
 {
+	struct ComputationGraph::BranchState
+	{
+		const IBranchLayer* layer;
+		std::vector<ComputationGraph> graphs;
+		std::vector<const Vector*> outputs;
+		std::vector<Vector> errors;
+	};
+	
 	ComputationGraph::ComputationGraph( const Network& network ) : 
 		mInputNode( std::make_shared<ComputationNode>(Vector()) )
 	{
 		mLayers = network.getLayers();
+		
+		for(const auto& layer : mLayers)
+		{
+			auto branching = dynamic_cast<const IBranchLayer*>( layer.get() );
+			if( !branching )
+				continue;
+			
+			auto state = std::make_unique<BranchState>();
+			state->layer = branching;
+			for(const auto& branch : branching->getBranches())
+			{
+				state->graphs.emplace_back( branch );
+			}
+			state->outputs.resize( state->graphs.size() );
+			state->errors.resize( state->graphs.size() );
+			mBranches.emplace( layer.get(), std::move(state) );
+		}
 	}
 	
+	ComputationGraph::ComputationGraph( ComputationGraph&& ) = default;
+	ComputationGraph& ComputationGraph::operator=( ComputationGraph&& ) = default;
+	ComputationGraph::~ComputationGraph() = default;
+	
 	using node_map = std::unordered_map<const ILayer*, std::shared_ptr<ComputationNode>>;
 	
 	std::shared_ptr<ComputationNode> getCompNode(node_map& nodes, const ILayer* layer, const std::shared_ptr<ComputationNode>& previous)
@@ -26,14 +57,35 @@ namespace net
 	
 	const Vector& ComputationGraph::forward( const Vector& input )
 	{
+		DQN_TRACE_SCOPE("ComputationGraph::forward");
 		mInputNode->out_cache() = input;
+		return evaluate();
+	}
+	
+	const Vector& ComputationGraph::evaluate()
+	{
+		mSteps.clear();
 		std::shared_ptr<ComputationNode> previous = mInputNode;
 
 		for(const auto& layer : mLayers)
 		{
 			// check if we have a node for this layer
 			std::shared_ptr<ComputationNode> target = getCompNode( mLayerNodeMap, layer.get(), previous );
-			layer->forward( *previous, *target );
+			
+			BranchState* branch = nullptr;
+			if( !mBranches.empty() )
+			{
+				auto found = mBranches.find( layer.get() );
+				if( found != mBranches.end() )
+					branch = found->second.get();
+			}
+			
+			if( branch )
+				forwardBranches( *branch, previous, *target );
+			else
+				layer->forward( *previous, *target );
+			
+			mSteps.push_back( Step{target.get(), branch} );
 			previous = target;
 		}
 		
@@ -42,9 +94,32 @@ namespace net
 		return output();
 	}
 	
+	void ComputationGraph::forwardBranches( BranchState& branch, const std::shared_ptr<ComputationNode>& input, ComputationNode& target )
+	{
+		for(std::size_t i = 0; i < branch.graphs.size(); ++i)
+		{
+			auto& graph = branch.graphs[i];
+			// the branch is fed directly by the node of the preceding layer
+			if( graph.mInputNode != input )
+			{
+				graph.mLayerNodeMap.clear();
+				graph.mInputNode = input;
+			}
+			branch.outputs[i] = &graph.evaluate();
+		}
+		
+		branch.layer->merge( branch.outputs, target.out_cache() );
+	}
+	
 	void ComputationGraph::clear()
 	{
 		mLayerNodeMap.clear();
+		mSteps.clear();
+		for(auto& branch : mBranches)
+		{
+			for(auto& graph : branch.second->graphs)
+				graph.clear();
+		}
 	}
 	
 	const Vector& ComputationGraph::output() const
@@ -54,6 +129,38 @@ namespace net
 	
 	void ComputationGraph::backpropagate( const Vector& error, Solver& solver )
 	{
-		mFinalNode->backpropagate(error, solver);
+		DQN_TRACE_SCOPE("ComputationGraph::backpropagate");
+		backpropagateToInput( error, solver );
+	}
+	
+	const Vector& ComputationGraph::backpropagateToInput( const Vector& error, Solver& solver )
+	{
+		const Vector* current = &error;
+		for(auto step = mSteps.rbegin(); step != mSteps.rend(); ++step)
+		{
+			if( step->branch )
+			{
+				current = &backwardBranches( *step->branch, *current, *step->node, solver );
+			} else
+			{
+				step->node->backward( *current, solver );
+				current = &step->node->error();
+			}
+		}
+		return *current;
+	}
+	
+	const Vector& ComputationGraph::backwardBranches( BranchState& branch, const Vector& error, ComputationNode& node, Solver& solver )
+	{
+		branch.layer->split( error, branch.errors );
+		
+		// the input of all branches is the same node, so their errors add up.
+		Vector& back = node.error_cache();
+		back.setZero( node.input().size() );
+		for(std::size_t i = 0; i < branch.graphs.size(); ++i)
+		{
+			back += branch.graphs[i].backpropagateToInput( branch.errors[i], solver );
+		}
+		return back;
 	}
 }
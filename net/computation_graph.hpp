@@ -3,6 +3,7 @@
 
 #include <unordered_map>
 #include <memory>
+#include <vector>
 #include "config.h"
 
 namespace net
@@ -12,11 +13,24 @@ namespace net
 	class Network;
 	class ComputationNode;
 	
+	/*! \class ComputationGraph
+		\brief Evaluates a Network and keeps all intermediate results for backpropagation.
+		\details Layers that derive from IBranchLayer are expanded into one sub-graph per branch.
+				All sub-graphs are fed directly by the node of the preceding layer, so the shared
+				trunk is computed only once, and their errors are summed up before they are propagated
+				further back. All nodes are cached, so repeated evaluations reuse their buffers.
+				The graph shares the layers of the network, so it stays valid when the parameters
+				are changed in place, e.g. by Network::update or Network::copy_parameters_from.
+	*/
 	class ComputationGraph
 	{
 	public:
 		ComputationGraph() = default;
 		ComputationGraph( const Network& net );
+		ComputationGraph( ComputationGraph&& );
+		ComputationGraph& operator=( ComputationGraph&& );
+		~ComputationGraph();
+		
 		const Vector& forward( const Vector& input );
 		void backpropagate( const Vector& error, Solver& solver );
 		void clear();
@@ -24,10 +38,29 @@ namespace net
 		// get computation results
 		const Vector& output() const;
 	private:
+		struct BranchState;
+		struct Step
+		{
+			ComputationNode* node;
+			BranchState* branch;
+		};
+		
+		// evaluates all layers, starting with the current input node.
+		const Vector& evaluate();
+		// propagates error back through all layers, and returns the error with respect to the input.
+		const Vector& backpropagateToInput( const Vector& error, Solver& solver );
+		
+		void forwardBranches( BranchState& branch, const std::shared_ptr<ComputationNode>& input, ComputationNode& target );
+		const Vector& backwardBranches( BranchState& branch, const Vector& error, ComputationNode& node, Solver& solver );
+		
 		std::shared_ptr<ComputationNode> mInputNode;
 		std::shared_ptr<ComputationNode> mFinalNode;
 		std::unordered_map<const ILayer*, std::shared_ptr<ComputationNode>> mLayerNodeMap;
+		std::unordered_map<const ILayer*, std::unique_ptr<BranchState>> mBranches;
 		std::vector<std::shared_ptr<ILayer>> mLayers;
+		
+		// nodes of the last forward pass, in order of evaluation
+		std::vector<Step> mSteps;
 	};
 }
 
@@ -3,15 +3,11 @@
 
 namespace net
 {
-void ComputationNode::backpropagate( const Vector& error, Solver& solver )
+void ComputationNode::backward( const Vector& error, Solver& solver )
 {
 	if(mLayer)
 	{
 		mLayer->backward(error, mError, *this, solver);
-		if(mSource)
-		{
-			mSource->backpropagate( mError, solver );
-		}
 	}
 }
 }
@@ -32,9 +32,12 @@ public:
 	const ILayer* layer() const { return mLayer; };
 
 	Vector& out_cache() { return mOutput; }
+	Vector& error_cache() { return mError; }
 	
-	// the interesting thing: backpropagate
-	void backpropagate( const Vector& error, Solver& solver );
+	// propagates error back through the layer of this node. The resulting error with
+	// respect to the input is stored in error(). Does not recurse into the source node,
+	// the ComputationGraph is responsible for the order of evaluation.
+	void backward( const Vector& error, Solver& solver );
 
 private:
 	std::shared_ptr<ComputationNode> mSource;
@@ -0,0 +1,49 @@
+#include "dueling_layer.hpp"
+#include <stdexcept>
+
+namespace net
+{
+namespace
+{
+	std::vector<Network> make_branches( Network value, Network advantage )
+	{
+		if( value.getOutputSize() != 1 )
+			throw std::invalid_argument("value stream of a dueling head has to produce exactly one output");
+		
+		std::vector<Network> branches;
+		branches.push_back( std::move(value) );
+		branches.push_back( std::move(advantage) );
+		return branches;
+	}
+}
+
+DuelingHead::DuelingHead( Network value, Network advantage ) :
+	IBranchLayer( make_branches( std::move(value), std::move(advantage) ) )
+{
+}
+
+std::size_t DuelingHead::getOutputSize() const
+{
+	return getAdvantageStream().getOutputSize();
+}
+
+void DuelingHead::merge( const std::vector<const Vector*>& branches, Vector& out ) const
+{
+	const Vector& value = *branches[0];
+	const Vector& advantage = *branches[1];
+	out = (advantage.array() - advantage.mean() + value[0]).matrix();
+}
+
+void DuelingHead::split( const Vector& error, std::vector<Vector>& branch_errors ) const
+{
+	// dQ_i/dV = 1, dQ_i/dA_j = delta_ij - 1/n
+	branch_errors[0].resize(1);
+	branch_errors[0][0] = error.sum();
+	branch_errors[1] = (error.array() - error.mean()).matrix();
+}
+
+std::unique_ptr<ILayer> DuelingHead::clone() const
+{
+	return std::make_unique<DuelingHead>( getValueStream().clone(), getAdvantageStream().clone() );
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "branch_layer.hpp"
+
+namespace net
+{
+/*! \class DuelingHead
+	\brief Output layer of a dueling network architecture.
+	\details Splits into a value stream V, which has to produce a single output, and an advantage stream A,
+			with one output per action. These are recombined as Q = V + A - mean(A).
+*/
+class DuelingHead : public IBranchLayer
+{
+public:
+	DuelingHead( Network value, Network advantage );
+
+	/// get the size of the layer output, i.e. the number of actions
+	std::size_t getOutputSize() const override;
+	
+	const Network& getValueStream() const { return mBranches[0]; }
+	const Network& getAdvantageStream() const { return mBranches[1]; }
+
+	void merge( const std::vector<const Vector*>& branches, Vector& out ) const override;
+	void split( const Vector& error, std::vector<Vector>& branch_errors ) const override;
+	
+	std::unique_ptr<ILayer> clone() const override;
+	
+	const char* getLayerType() const override { return "dueling"; }
+};
+}
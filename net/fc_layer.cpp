@@ -26,6 +26,11 @@ void FcLayer::update(Solver& solver)
 	solver.update( mMatrix );
 }
 
+void FcLayer::getParameters( std::vector<Matrix*>& params )
+{
+	params.push_back( &mMatrix );
+}
+
 std::unique_ptr<ILayer> FcLayer::clone() const
 {
 	return std::make_unique<FcLayer>( *this );
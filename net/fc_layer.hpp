@@ -22,7 +22,11 @@ public:
 
 	void update(Solver& solver) override;
 	
+	void getParameters( std::vector<Matrix*>& params ) override;
+	
 	std::unique_ptr<ILayer> clone() const override;
+	
+	const char* getLayerType() const override { return "fc"; }
 private:
 	Matrix mMatrix;
 };
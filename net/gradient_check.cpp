@@ -0,0 +1,160 @@
+#include "gradient_check.hpp"
+#include "layer.hpp"
+#include "network.hpp"
+#include "computation_graph.hpp"
+#include "computation_node.hpp"
+#include "solver.hpp"
+#include "rmsprop.hpp"
+#include "util/random.hpp"
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+
+namespace net
+{
+namespace
+{
+	Vector random_vector( std::size_t size, util::Random& random )
+	{
+		Vector v( size );
+		for(std::size_t i = 0; i < size; ++i)
+			v[i] = 2 * random.uniform() - 1;
+		return v;
+	}
+	
+	double default_step()
+	{
+		// minimizes truncation plus rounding error of central differences
+		return std::cbrt( std::numeric_limits<number_t>::epsilon() );
+	}
+	
+	class Checker
+	{
+	public:
+		Checker( const GradientCheckOptions& options, std::function<const Vector&( const Vector& )> forward, Vector weights ) :
+			mStep( options.step > 0 ? options.step : default_step() ), mForward( std::move(forward) ), mWeights( std::move(weights) )
+		{
+		}
+		
+		// the loss is accumulated in double, so that only the network itself runs in number_t
+		double loss( const Vector& input ) const
+		{
+			const Vector& out = mForward( input );
+			double sum = 0;
+			for(Eigen::Index i = 0; i < out.size(); ++i)
+				sum += (double)mWeights[i] * out[i];
+			return sum;
+		}
+		
+		// compares analytic with the finite difference derivative of the loss with respect to value
+		void compare( number_t& value, double analytic, const Vector& input, const std::string& name )
+		{
+			number_t original = value;
+			number_t h = mStep * std::max( 1.0, std::abs( (double)original ) );
+			value = original + h;
+			double plus = loss( input );
+			value = original - h;
+			double minus = loss( input );
+			value = original;
+			// the actual step after rounding to number_t
+			double numeric = (plus - minus) / ((double)(number_t)(original + h) - (double)(number_t)(original - h));
+			
+			double error = std::abs( analytic - numeric ) / std::max( {1.0, std::abs( analytic ), std::abs( numeric )} );
+			++mResult.checked;
+			if( error >= mResult.max_error )
+			{
+				mResult.max_error = error;
+				mResult.worst = name;
+			}
+		}
+		
+		void compare_parameters( const std::vector<Matrix*>& params, const Solver& solver, const Vector& input )
+		{
+			for(std::size_t p = 0; p < params.size(); ++p)
+			{
+				Matrix& param = *params[p];
+				const Matrix& gradient = solver.getGradient( param );
+				for(Eigen::Index c = 0; c < param.cols(); ++c)
+				{
+					for(Eigen::Index r = 0; r < param.rows(); ++r)
+					{
+						compare( param(r, c), gradient(r, c), input, "parameter " + std::to_string(p) + " (" +
+								 std::to_string(r) + ", " + std::to_string(c) + ")" );
+					}
+				}
+			}
+		}
+		
+		const GradientCheckResult& result() const { return mResult; }
+		
+	private:
+		double mStep;
+		std::function<const Vector&( const Vector& )> mForward;
+		Vector mWeights;
+		GradientCheckResult mResult;
+	};
+	
+	std::unique_ptr<Solver> make_solver()
+	{
+		// only used to collect the gradients, nothing is updated
+		return std::make_unique<Solver>( std::make_unique<RMSProp>( 0.9, 0.001, 0.01 ) );
+	}
+}
+	
+	GradientCheckResult check_layer_gradients( const ILayer& layer, std::size_t input_size, const GradientCheckOptions& options )
+	{
+		util::Random random( options.seed );
+		auto copy = layer.clone();
+		Vector input = random_vector( input_size, random );
+		Vector weights = random_vector( copy->getOutputSize(), random );
+		
+		auto source = std::make_shared<ComputationNode>( input );
+		ComputationNode output( source, Vector(), copy.get() );
+		auto solver = make_solver();
+		copy->forward( *source, output );
+		output.backward( weights, *solver );
+		Vector input_gradient = output.error();
+		
+		ComputationNode probe( source, Vector(), copy.get() );
+		Checker checker( options, [&]( const Vector& x ) -> const Vector&
+		{
+			source->out_cache() = x;
+			copy->forward( *source, probe );
+			return probe.output();
+		}, weights );
+		
+		std::vector<Matrix*> params;
+		copy->getParameters( params );
+		checker.compare_parameters( params, *solver, input );
+		for(Eigen::Index i = 0; i < input.size(); ++i)
+		{
+			Vector x = input;
+			checker.compare( x[i], input_gradient[i], x, "input " + std::to_string(i) );
+		}
+		return checker.result();
+	}
+	
+	GradientCheckResult check_network_gradients( const Network& network, std::size_t input_size, const GradientCheckOptions& options )
+	{
+		util::Random random( options.seed );
+		Network copy = network.clone();
+		ComputationGraph graph( copy );
+		Vector input = random_vector( input_size, random );
+		Vector weights = random_vector( copy.getOutputSize(), random );
+		
+		auto solver = make_solver();
+		graph.forward( input );
+		graph.backpropagate( weights, *solver );
+		
+		Checker checker( options, [&]( const Vector& x ) -> const Vector& { return graph.forward( x ); }, weights );
+		checker.compare_parameters( copy.getParameters(), *solver, input );
+		return checker.result();
+	}
+	
+	double gradient_tolerance()
+	{
+		// rounding in the forward pass dominates, which is about epsilon / step relative to the loss
+		return 10 * std::numeric_limits<number_t>::epsilon() / default_step();
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "config.h"
+#include <cstdint>
+#include <string>
+
+namespace net
+{
+	struct GradientCheckOptions
+	{
+		// finite difference step, relative to the magnitude of the value. 0 picks a step that suits number_t.
+		double step = 0;
+		std::uint64_t seed = 1;		// for the input and the weights of the loss
+	};
+	
+	struct GradientCheckResult
+	{
+		std::size_t checked = 0;	// number of compared derivatives
+		// largest error |analytic - numeric| / max(1, |analytic|, |numeric|)
+		double max_error = 0;
+		std::string worst;			// which derivative had the largest error, e.g. "parameter 1 (3, 0)"
+	};
+	
+	// compares the derivatives that backpropagation computes with central finite differences, for
+	// every parameter and every input entry. The loss is a random linear combination of the outputs.
+	// The layer is not modified, all checks work on a clone. Branch layers can only be checked as part
+	// of a network.
+	GradientCheckResult check_layer_gradients( const ILayer& layer, std::size_t input_size, const GradientCheckOptions& options = {} );
+	
+	// the same for all parameters of a network, evaluated by a ComputationGraph.
+	GradientCheckResult check_network_gradients( const Network& network, std::size_t input_size, const GradientCheckOptions& options = {} );
+	
+	// tolerance for max_error that a correct implementation meets with number_t
+	double gradient_tolerance();
+}
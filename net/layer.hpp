@@ -2,12 +2,15 @@
 
 #include "config.h"
 #include "computation_node.hpp"
+#include <vector>
 
 namespace net
 {
 class ILayer
 {
 public:
+	virtual ~ILayer() = default;
+
 	/// get the size of the layer output
 	virtual std::size_t getOutputSize() const = 0;
 	
@@ -30,8 +33,14 @@ public:
 	/// update the parameters according to the solver.
 	virtual void update(Solver& solver) = 0;
 	
+	/// appends pointers to all trainable parameters of this layer to params.
+	virtual void getParameters( std::vector<Matrix*>& params ) = 0;
+	
 	/// creates a copy of this layer.
 	virtual std::unique_ptr<ILayer> clone() const = 0;
+	
+	/// name of the layer type, used e.g. to identify the layer in checkpoints.
+	virtual const char* getLayerType() const = 0;
 private:
 	/// propagates input forward and calculates output.
 	virtual void process(const Vector& input, Vector& output) const = 0;
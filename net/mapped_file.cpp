@@ -0,0 +1,43 @@
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace net
+{
+MappedFile::MappedFile( const std::string& path )
+{
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+		throw std::runtime_error("could not open " + path + ": " + std::strerror(errno));
+
+	struct stat info;
+	if( ::fstat( fd, &info ) != 0 || info.st_size == 0 )
+	{
+		::close( fd );
+		throw std::runtime_error(path + " is empty or cannot be accessed");
+	}
+
+	mSize = info.st_size;
+	void* mapping = ::mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd );
+	if( mapping == MAP_FAILED )
+		throw std::runtime_error("could not map " + path + ": " + std::strerror(errno));
+	mData = static_cast<const char*>( mapping );
+}
+
+MappedFile::~MappedFile()
+{
+	::munmap( const_cast<char*>(mData), mSize );
+}
+
+void throwTruncated()
+{
+	throw std::runtime_error("file is truncated or corrupted");
+}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace net
+{
+	/*! \class MappedFile
+		\brief Read-only memory mapping of a whole file.
+	*/
+	class MappedFile
+	{
+	public:
+		// maps the file at path. Throws std::runtime_error if it cannot be opened or is empty.
+		explicit MappedFile( const std::string& path );
+		~MappedFile();
+		MappedFile( const MappedFile& ) = delete;
+		MappedFile& operator=( const MappedFile& ) = delete;
+
+		const char* data() const { return mData; }
+		std::size_t size() const { return mSize; }
+
+		// bounds checked access to count objects of type T at offset.
+		// Throws std::runtime_error if they do not fit into the file.
+		template<class T>
+		const T* at( std::uint64_t offset, std::uint64_t count = 1 ) const;
+
+	private:
+		const char* mData = nullptr;
+		std::size_t mSize = 0;
+	};
+
+	void throwTruncated();
+
+	template<class T>
+	const T* MappedFile::at( std::uint64_t offset, std::uint64_t count ) const
+	{
+		if( offset > mSize || count > (mSize - offset) / sizeof(T) )
+			throwTruncated();
+		return reinterpret_cast<const T*>( mData + offset );
+	}
+}
@@ -1,9 +1,13 @@
 #include "network.hpp"
+#include "util/trace.hpp"
+#include <stdexcept>
+#include <typeinfo>
 
 namespace net
 {
 Network& Network::add_layer_imp( layer_t layer )
 {
+	layer->getParameters( mParameters );
 	mLayers.push_back( std::move(layer) );
 	return *this;
 }
@@ -25,6 +29,13 @@ ComputationNode Network::operator()( Vector input ) const
 	return forward( std::move(input) );
 }
 */
+std::size_t Network::getOutputSize() const
+{
+	if(mLayers.empty())
+		return 0;
+	return mLayers.back()->getOutputSize();
+}
+
 void Network::update(Solver& solver)
 {
     for(auto& l : mLayers)
@@ -35,11 +46,56 @@ void Network::update(Solver& solver)
 
 Network Network::clone() const
 {
+	DQN_TRACE_SCOPE("Network::clone");
 	Network newnet;
 	for(const auto& layer : mLayers)
 	{
-		newnet.mLayers.push_back( layer->clone() );
+		newnet.add_layer_imp( layer->clone() );
 	}
 	return newnet;
 }
+
+bool Network::is_compatible( const Network& other ) const
+{
+	if( mLayers.size() != other.mLayers.size() || mParameters.size() != other.mParameters.size() )
+		return false;
+	
+	for(std::size_t i = 0; i < mLayers.size(); ++i)
+	{
+		const ILayer& mine = *mLayers[i];
+		const ILayer& theirs = *other.mLayers[i];
+		if( typeid(mine) != typeid(theirs) || mine.getOutputSize() != theirs.getOutputSize() )
+			return false;
+	}
+	
+	for(std::size_t i = 0; i < mParameters.size(); ++i)
+	{
+		if( mParameters[i]->rows() != other.mParameters[i]->rows() || mParameters[i]->cols() != other.mParameters[i]->cols() )
+			return false;
+	}
+	return true;
+}
+
+void Network::copy_parameters_from( const Network& source )
+{
+	if( !is_compatible(source) )
+		throw std::invalid_argument("cannot copy parameters between networks of different structure");
+	
+	for(std::size_t i = 0; i < mParameters.size(); ++i)
+	{
+		*mParameters[i] = *source.mParameters[i];
+	}
+}
+
+void Network::blend_parameters_from( const Network& source, number_t tau )
+{
+	if( !is_compatible(source) )
+		throw std::invalid_argument("cannot blend parameters between networks of different structure");
+	
+	for(std::size_t i = 0; i < mParameters.size(); ++i)
+	{
+		auto target = mParameters[i]->array();
+		target += tau * (source.mParameters[i]->array() - target);
+	}
+}
 }
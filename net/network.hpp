@@ -37,16 +37,38 @@ public:
 	ComputationNode operator()( Vector input ) const;
 */	
 	const std::vector<layer_t>& getLayers() const { return mLayers; }
+	
+	// size of the output of the last layer. zero for an empty network.
+	std::size_t getOutputSize() const;
+
+	// all trainable parameters, in layer order.
+	const std::vector<Matrix*>& getParameters() const { return mParameters; }
 
 	// update all layers
 	void update(Solver& solver);
 	
 	// creates a deep copy of the network
 	Network clone() const;
+	
+	// checks whether other consists of the same layer types with the same parameter shapes,
+	// i.e. whether parameters can be exchanged between the two networks.
+	bool is_compatible( const Network& other ) const;
+	
+	// overwrites the parameters with those of source. This reuses the existing buffers, so it does
+	// not allocate, and ComputationGraphs of this network stay valid.
+	// Throws std::invalid_argument if source is not compatible.
+	void copy_parameters_from( const Network& source );
+	
+	// moves the parameters towards those of source: p = tau * p_source + (1 - tau) * p.
+	// Throws std::invalid_argument if source is not compatible.
+	void blend_parameters_from( const Network& source, number_t tau );
 
 private:
 	Network& add_layer_imp( layer_t layer );
 
 	std::vector<layer_t> mLayers;
+	// pointers into the parameters of mLayers. These stay valid when the network is moved,
+	// as the layers themselves are kept on the heap.
+	std::vector<Matrix*> mParameters;
 };
 }
@@ -16,7 +16,7 @@ void ReLULayer::process(const Vector& input, Vector& out) const
 
 void ReLULayer::backward(const Vector& error, Vector& back, const ComputationNode& compute, Solver& solver) const
 {
-	auto deriv = [](number_t v) {return v > 0 ? 1 : 0;};
+	auto deriv = [](number_t v) -> number_t {return v > 0 ? 1 : 0;};
 	back = error.array() * (compute.output().unaryExpr(deriv)).array();
 	solver(mBias, back);
 }
@@ -26,6 +26,11 @@ void ReLULayer::update(Solver& solver)
 	solver.update( mBias );
 }
 
+void ReLULayer::getParameters( std::vector<Matrix*>& params )
+{
+	params.push_back( &mBias );
+}
+
 std::unique_ptr<ILayer> ReLULayer::clone() const
 {
 	return std::make_unique<ReLULayer>(*this);
@@ -3,35 +3,91 @@
 
 namespace net
 {
-RMSProp::RMSProp(double l, double r, double e) : lambda(l), rate(r), epsilon(e)
+template<class State>
+BasicRMSProp<State>::BasicRMSProp(double l, double r, double e) : lambda(l), rate(r), epsilon(e)
 {
 }
 
-Matrix& RMSProp::getRMS(const Matrix& parameter)
+template<class State>
+auto BasicRMSProp<State>::getRMS(const Matrix& parameter) -> state_t&
 {
 	auto param = parameter.data();
-	if(mRMS.count(param))
+	auto found = mRMS.find(param);
+	if(found != mRMS.end())
 	{
-		return mRMS.at(param);
+		return found->second;
 	} else
 	{
-		auto res = mRMS.emplace(param, parameter.array() * parameter.array());
+		auto res = mRMS.emplace(param, parameter.template cast<State>().array().square());
 		assert(res.second);
 		return res.first->second;
 	}
 }
 
-const Matrix& RMSProp::updateRMS( const Matrix& parameter, const Matrix& gradient )
+template<class State>
+bool BasicRMSProp<State>::hasState(const Matrix& parameter) const
 {
-	Matrix& rms = getRMS( parameter );
-	rms *= lambda;
-	rms += (1-lambda) * (gradient.array() * gradient.array()).matrix();
+	return mRMS.count( parameter.data() ) != 0;
+}
+
+template<class State>
+bool BasicRMSProp<State>::getState(const Matrix& parameter, Eigen::Ref<Matrix> state) const
+{
+	auto found = mRMS.find( parameter.data() );
+	if( found == mRMS.end() )
+		return false;
+	assert( state.rows() == parameter.rows() && state.cols() == parameter.cols() );
+	state = found->second.template cast<number_t>();
+	return true;
+}
+
+template<class State>
+void BasicRMSProp<State>::setState(const Matrix& parameter, const Eigen::Ref<const Matrix>& state)
+{
+	assert( state.rows() == parameter.rows() && state.cols() == parameter.cols() );
+	mRMS[parameter.data()] = state.template cast<State>();
+}
+
+template<class State>
+bool BasicRMSProp<State>::copyState(const Matrix& parameter, const IUpdateRule& source, const Matrix& source_parameter)
+{
+	auto same = dynamic_cast<const BasicRMSProp<State>*>( &source );
+	if( !same )
+		return IUpdateRule::copyState( parameter, source, source_parameter );
+	
+	const state_t* state = same->findState( source_parameter );
+	if( !state )
+		return false;
+	assert( state->rows() == parameter.rows() && state->cols() == parameter.cols() );
+	// assigns in place if parameter already has a state of this size
+	mRMS[parameter.data()] = *state;
+	return true;
+}
+
+template<class State>
+auto BasicRMSProp<State>::findState(const Matrix& parameter) const -> const state_t*
+{
+	auto found = mRMS.find( parameter.data() );
+	return found == mRMS.end() ? nullptr : &found->second;
+}
+
+template<class State>
+auto BasicRMSProp<State>::updateRMS( const Matrix& parameter, const Matrix& gradient ) -> const state_t&
+{
+	state_t& rms = getRMS( parameter );
+	rms *= State(lambda);
+	rms += State(1-lambda) * gradient.template cast<State>().array().square().matrix();
 	return rms;
 }
 
-void RMSProp::updateParameter(Matrix& parameter, const Matrix& gradient)
+template<class State>
+void BasicRMSProp<State>::updateParameter(Matrix& parameter, const Matrix& gradient)
 {
-	auto rms = updateRMS(parameter, gradient);
-	parameter -= (rate * gradient.array() / sqrt(rms.array() + epsilon)).matrix();
+	// a reference, copying the running mean would allocate in every update
+	const state_t& rms = updateRMS(parameter, gradient);
+	parameter -= (State(rate) * gradient.template cast<State>().array() / sqrt(rms.array() + State(epsilon))).template cast<number_t>().matrix();
 }
+
+template class BasicRMSProp<float>;
+template class BasicRMSProp<double>;
 }
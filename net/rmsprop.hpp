@@ -5,23 +5,44 @@
 
 namespace net
 {
-class RMSProp : public IUpdateRule
+/*! \class BasicRMSProp
+	\brief RMSProp update rule that keeps the running mean of the squared gradients in State.
+	\details With State = double the mean and the step are computed in double and only the result
+			is rounded to number_t, which avoids the loss of small gradients against a large mean
+			at the cost of twice the memory traffic in the update. Instantiated for float and double.
+*/
+template<class State>
+class BasicRMSProp : public IUpdateRule
 {
 public:
-	RMSProp(double lambda, double rate, double epsilon);
+	BasicRMSProp(double lambda, double rate, double epsilon);
 
 	void updateParameter(Matrix& parameter, const Matrix& gradient) override;
+
+	void setRate( double new_rate ) override { rate = new_rate; };
+
+	// running mean of the squared gradients
+	bool hasState(const Matrix& parameter) const override;
+	bool getState(const Matrix& parameter, Eigen::Ref<Matrix> state) const override;
+	void setState(const Matrix& parameter, const Eigen::Ref<const Matrix>& state) override;
+	// copies the state without conversion if source is a BasicRMSProp<State>, too
+	bool copyState(const Matrix& parameter, const IUpdateRule& source, const Matrix& source_parameter) override;
 	
-	void setRate( double new_rate ) { rate = new_rate; };
+	// the running mean of parameter in its own precision, or nullptr if there is none
+	const MatrixT<State>* findState(const Matrix& parameter) const;
 
 private:
+	using state_t = MatrixT<State>;
+
 	double lambda;
 	double rate;
 	double epsilon;
 
-	Matrix& getRMS(const Matrix& parameter);
-	const Matrix& updateRMS( const Matrix& parameter, const Matrix& gradient );
+	state_t& getRMS(const Matrix& parameter);
+	const state_t& updateRMS( const Matrix& parameter, const Matrix& gradient );
 
-	std::unordered_map<const number_t*, Matrix> mRMS;
+	std::unordered_map<const number_t*, state_t> mRMS;
 };
+
+using RMSProp = BasicRMSProp<number_t>;
 }
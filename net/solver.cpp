@@ -1,4 +1,5 @@
 #include "solver.hpp"
+#include "util/trace.hpp"
 
 namespace net
 {
@@ -32,7 +33,17 @@ Matrix& Solver::getGradientBuffer(const number_t* param, std::size_t rows, std::
 
 void Solver::update(Matrix& param)
 {
+	DQN_TRACE_SCOPE("Solver::update");
 	mUpdateRule->updateParameter(param, getGradient(param));
 	getGradient(param).setZero( param.rows(), param.cols() );
 }
+
+bool IUpdateRule::copyState(const Matrix& parameter, const IUpdateRule& source, const Matrix& source_parameter)
+{
+	Matrix state( source_parameter.rows(), source_parameter.cols() );
+	if( !source.getState( source_parameter, state ) )
+		return false;
+	setState( parameter, state );
+	return true;
+}
 }
@@ -24,6 +24,9 @@ public:
 	}
 
 	void update(Matrix& param);
+	
+	IUpdateRule& getUpdateRule() { return *mUpdateRule; }
+	const IUpdateRule& getUpdateRule() const { return *mUpdateRule; }
 
 	// const version to retrieve the gradient. Throws an exception, if
 	// no gradient has been saved for value.
@@ -48,6 +51,22 @@ class IUpdateRule
 	public:
 		virtual ~IUpdateRule() {};
 		virtual void updateParameter(Matrix& parameter, const Matrix& gradient) = 0;
+		
+		// learning rate, e.g. for learning rate schedules
+		virtual void setRate( double rate ) = 0;
+		
+		// internal per-parameter state of the rule, e.g. for checkpoints. The rule may keep the state
+		// in a different precision, it is converted from and to number_t.
+		// getState copies the state into a matrix of the size of parameter, and returns false
+		// if no state is kept for parameter.
+		virtual bool hasState(const Matrix& parameter) const { return false; }
+		virtual bool getState(const Matrix& parameter, Eigen::Ref<Matrix> state) const { return false; }
+		virtual void setState(const Matrix& parameter, const Eigen::Ref<const Matrix>& state) { }
+		
+		// copies the state that source keeps for source_parameter to parameter, and returns false if
+		// there is none. Rules that keep the state in another precision than number_t override this,
+		// so that copies between rules of the same type do not round the state to number_t.
+		virtual bool copyState(const Matrix& parameter, const IUpdateRule& source, const Matrix& source_parameter);
 };
 
 }
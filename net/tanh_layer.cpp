@@ -12,7 +12,7 @@ std::size_t TanhLayer::getOutputSize() const
 
 void TanhLayer::process(const Vector& input, Vector& out) const
 {
-	out = (mBias + input).unaryExpr([](float x) { return std::tanh(x);} );
+	out = (mBias + input).unaryExpr([](number_t x) { return std::tanh(x);} );
 }
 
 void TanhLayer::backward(const Vector& error, Vector& back, const ComputationNode& compute, Solver& solver) const
@@ -27,6 +27,11 @@ void TanhLayer::update(Solver& solver)
 	solver.update( mBias );
 }
 
+void TanhLayer::getParameters( std::vector<Matrix*>& params )
+{
+	params.push_back( &mBias );
+}
+
 std::unique_ptr<ILayer> TanhLayer::clone() const
 {
 	return std::unique_ptr<ILayer>( new TanhLayer(*this) );
@@ -1,5 +1,7 @@
 #include "action.h"
 #include "net/computation_graph.hpp"
+#include "util/trace.hpp"
+#include <cassert>
 
 namespace qlearn
 {
@@ -8,8 +10,75 @@ namespace qlearn
 	{
 		const auto& result = graph.forward( situation );
 		// greedy algorithm that generates the next action.
-		int row, col;
-		float quality = result.maxCoeff(&row,&col);
-		return {row, quality};
+		Eigen::Index row, col;
+		number_t quality = result.maxCoeff(&row,&col);
+		return {std::size_t(row), quality};
+	}
+	
+	void getBestActions( const Eigen::Ref<const Matrix>& qvalues, Eigen::Ref<Eigen::VectorXi> index,
+						 Eigen::Ref<Vector> best, Action* actions )
+	{
+		assert( qvalues.cols() > 0 && index.size() == qvalues.rows() && best.size() == qvalues.rows() );
+		// the columns are contiguous, so each comparison works on all rows at once
+		best = qvalues.col(0);
+		index.setZero();
+		for(int a = 1; a < qvalues.cols(); ++a)
+		{
+			auto better = qvalues.col(a).array() > best.array();
+			index = better.select( a, index );
+			best = better.select( qvalues.col(a), best );
+		}
+		
+		for(int i = 0; i < qvalues.rows(); ++i)
+			actions[i] = Action{ std::size_t(index[i]), best[i] };
+	}
+	
+	EpsilonGreedy::EpsilonGreedy( std::size_t action_count, util::Random random ) : 
+		mActionCount( action_count ), mRandom( random )
+	{
+	}
+	
+	const std::vector<Action>& EpsilonGreedy::select( ComputationGraph& graph, const Matrix& states, float epsilon )
+	{
+		DQN_TRACE_SCOPE("EpsilonGreedy::select");
+		const std::size_t count = states.cols();
+		mActions.resize( count );
+		// size all caches for the whole batch up front, so a later call with more greedy states does not
+		// allocate, even if the first calls explore everything
+		if( mQValues.rows() != (int)count || mQValues.cols() != (int)mActionCount )
+		{
+			mQValues.resize( count, mActionCount );
+			mBestIndex.resize( count );
+			mBestValue.resize( count );
+			mGreedy.reserve( count );
+			mBestActions.reserve( count );
+		}
+		mInput.resize( states.rows() );
+		mGreedy.clear();
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			if( mRandom.bernoulli( epsilon ) )
+				mActions[i] = Action{ mRandom.uniform_int( mActionCount ), 0 };
+			else
+				mGreedy.push_back( i );
+		}
+		
+		if( mGreedy.empty() )
+			return mActions;
+		
+		// one row of Q-values per greedy state
+		const std::size_t greedy = mGreedy.size();
+		for(std::size_t k = 0; k < greedy; ++k)
+		{
+			mInput = states.col( mGreedy[k] );
+			mQValues.row( k ) = graph.forward( mInput ).transpose();
+		}
+		
+		mBestActions.resize( greedy );
+		getBestActions( mQValues.topRows( greedy ), mBestIndex.head( greedy ), mBestValue.head( greedy ), mBestActions.data() );
+		for(std::size_t k = 0; k < greedy; ++k)
+			mActions[mGreedy[k]] = mBestActions[k];
+		
+		return mActions;
 	}
 }
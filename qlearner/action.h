@@ -1,6 +1,8 @@
 #pragma once
 
 #include "config.h"
+#include "util/random.hpp"
+#include <vector>
 
 namespace net
 {
@@ -13,8 +15,50 @@ namespace qlearn
 	struct Action
 	{
 		std::size_t id;
-		float score;
+		number_t score;
 	};
 	
 	Action getAction(net::ComputationGraph& graph, const Vector& situation);
+	
+	// greedy action for each row of qvalues, which has one column per action. The rows are processed
+	// in parallel, so the comparisons vectorize. Ties go to the smaller action id, as in getAction.
+	// index and best are used as buffers and need one entry per row.
+	void getBestActions( const Eigen::Ref<const Matrix>& qvalues, Eigen::Ref<Eigen::VectorXi> index,
+						 Eigen::Ref<Vector> best, Action* actions );
+	
+	/*! \class EpsilonGreedy
+		\brief Epsilon-greedy action selection for a batch of states.
+		\details All exploration decisions are drawn before the network is used, and only the states
+				that act greedily are evaluated. Their Q-values are collected into a matrix, whose
+				greedy actions are determined with getBestActions. Random actions get a score of 0,
+				like in QCore::forward. Does not allocate once it has seen the batch size.
+	*/
+	class EpsilonGreedy
+	{
+	public:
+		EpsilonGreedy( std::size_t action_count, util::Random random );
+		
+		// selects an action for each column of states.
+		const std::vector<Action>& select( net::ComputationGraph& graph, const Matrix& states, float epsilon );
+		
+		const std::vector<Action>& getActions() const { return mActions; }
+		// number of states that were evaluated by the network in the last call to select
+		std::size_t getGreedyCount() const { return mGreedy.size(); }
+		
+	private:
+		std::size_t mActionCount;
+		util::Random mRandom;
+		
+		std::vector<Action> mActions;
+		// columns of the states that act greedily
+		std::vector<std::size_t> mGreedy;
+		
+		// caches to prevent reallocation. They are sized for the whole batch, and only the first
+		// entries are used for the greedy states.
+		Vector mInput;
+		Matrix mQValues;
+		Eigen::VectorXi mBestIndex;
+		Vector mBestValue;
+		std::vector<Action> mBestActions;
+	};
 }
@@ -0,0 +1,462 @@
+#include "experiment.hpp"
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/relu_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/dueling_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+#include "util/random.hpp"
+#include <boost/property_tree/json_parser.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace qlearn
+{
+namespace
+{
+	using boost::property_tree::ptree;
+	
+	// defaults of the optimizer
+	const double DEFAULT_DECAY = 0.9;
+	const double DEFAULT_RATE = 0.001;
+	const double DEFAULT_EPSILON = 0.01;
+	
+	[[noreturn]] void fail( const std::string& path, const std::string& what )
+	{
+		throw std::invalid_argument( path + ": " + what );
+	}
+	
+	std::string child_path( const std::string& path, const std::string& key )
+	{
+		return path.empty() ? key : path + "." + key;
+	}
+	
+	std::string index_path( const std::string& path, std::size_t index )
+	{
+		return path + "[" + std::to_string(index) + "]";
+	}
+	
+	bool is_value( const ptree& node )
+	{
+		return node.empty();
+	}
+	
+	// rejects keys that are not in allowed
+	void check_keys( const ptree& node, const std::string& path, std::initializer_list<const char*> allowed )
+	{
+		if( is_value( node ) )
+			fail( path, "expected an object" );
+		for(const auto& child : node)
+		{
+			if( std::find_if( allowed.begin(), allowed.end(), [&](const char* key) { return child.first == key; } ) == allowed.end() )
+				fail( child_path( path, child.first.empty() ? "[]" : child.first ), "unknown key" );
+		}
+	}
+	
+	std::vector<const ptree*> get_list( const ptree& node, const std::string& path )
+	{
+		std::vector<const ptree*> list;
+		for(const auto& child : node)
+		{
+			if( !child.first.empty() )
+				fail( path, "expected a list" );
+			list.push_back( &child.second );
+		}
+		return list;
+	}
+	
+	const ptree* find( const ptree& node, const char* key )
+	{
+		auto found = node.find( key );
+		return found == node.not_found() ? nullptr : &found->second;
+	}
+	
+	double to_number( const ptree& node, const std::string& path )
+	{
+		if( !is_value( node ) )
+			fail( path, "expected a number" );
+		std::istringstream stream( node.data() );
+		double value;
+		if( !(stream >> value) || !stream.eof() || !std::isfinite( value ) )
+			fail( path, "'" + node.data() + "' is not a number" );
+		return value;
+	}
+	
+	std::size_t to_count( const ptree& node, const std::string& path )
+	{
+		double value = to_number( node, path );
+		if( value < 0 || value != std::floor( value ) || value > 1e15 )
+			fail( path, "'" + node.data() + "' is not a non-negative integer" );
+		return (std::size_t)value;
+	}
+	
+	const ptree& require( const ptree& node, const std::string& path, const char* key )
+	{
+		const ptree* child = find( node, key );
+		if( !child )
+			fail( child_path( path, key ), "missing" );
+		return *child;
+	}
+	
+	double get_number( const ptree& node, const std::string& path, const char* key, double fallback )
+	{
+		const ptree* child = find( node, key );
+		return child ? to_number( *child, child_path( path, key ) ) : fallback;
+	}
+	
+	std::size_t get_count( const ptree& node, const std::string& path, const char* key, std::size_t fallback )
+	{
+		const ptree* child = find( node, key );
+		return child ? to_count( *child, child_path( path, key ) ) : fallback;
+	}
+	
+	void check_range( double value, double low, double high, const std::string& path )
+	{
+		if( value < low || value > high )
+			fail( path, "has to be in [" + std::to_string(low) + ", " + std::to_string(high) + "]" );
+	}
+	
+	Schedule parse_schedule( const ptree& node, const std::string& path )
+	{
+		if( is_value( node ) )
+			return to_number( node, path );
+		
+		std::string type = require( node, path, "type" ).data();
+		if( type == "constant" )
+		{
+			check_keys( node, path, {"type", "value"} );
+			return to_number( require( node, path, "value" ), child_path( path, "value" ) );
+		} else if( type == "linear" || type == "cosine" )
+		{
+			check_keys( node, path, {"type", "start", "end", "steps"} );
+			double start = to_number( require( node, path, "start" ), child_path( path, "start" ) );
+			double end = to_number( require( node, path, "end" ), child_path( path, "end" ) );
+			std::size_t steps = to_count( require( node, path, "steps" ), child_path( path, "steps" ) );
+			return type == "linear" ? Schedule::linear( start, end, steps ) : Schedule::cosine( start, end, steps );
+		} else if( type == "exponential" )
+		{
+			check_keys( node, path, {"type", "start", "decay", "floor"} );
+			double start = to_number( require( node, path, "start" ), child_path( path, "start" ) );
+			double decay = to_number( require( node, path, "decay" ), child_path( path, "decay" ) );
+			if( decay <= 0 )
+				fail( child_path( path, "decay" ), "has to be positive" );
+			return Schedule::exponential( start, decay, get_number( node, path, "floor", 0 ) );
+		} else if( type == "piecewise" )
+		{
+			check_keys( node, path, {"type", "segments"} );
+			std::string list_path = child_path( path, "segments" );
+			std::vector<std::pair<std::size_t, Schedule>> segments;
+			auto list = get_list( require( node, path, "segments" ), list_path );
+			for(std::size_t i = 0; i < list.size(); ++i)
+			{
+				std::string segment_path = index_path( list_path, i );
+				check_keys( *list[i], segment_path, {"from", "schedule"} );
+				std::size_t from = to_count( require( *list[i], segment_path, "from" ), child_path( segment_path, "from" ) );
+				if( segments.empty() ? from != 0 : from <= segments.back().first )
+					fail( segment_path, "segments have to start at 0 and at increasing steps" );
+				segments.emplace_back( from, parse_schedule( require( *list[i], segment_path, "schedule" ), child_path( segment_path, "schedule" ) ) );
+			}
+			if( segments.empty() )
+				fail( list_path, "needs at least one segment" );
+			return Schedule::piecewise( std::move(segments) );
+		}
+		fail( child_path( path, "type" ), "unknown schedule type '" + type + "'" );
+	}
+	
+	Config parse_config( const ptree& root )
+	{
+		std::size_t inputs = to_count( require( root, "", "inputs" ), "inputs" );
+		std::size_t actions = to_count( require( root, "", "actions" ), "actions" );
+		if( inputs == 0 || actions == 0 )
+			fail( inputs == 0 ? "inputs" : "actions", "has to be positive" );
+		
+		static const ptree empty;
+		const ptree* found = find( root, "learner" );
+		const ptree& node = found ? *found : empty;
+		const std::string path = "learner";
+		if( found )
+			check_keys( node, path, {"memory", "batch_size", "steps_per_batch", "discount_factor", "update_interval",
+									 "target_tau", "init_memory_size", "epsilon_steps", "init_epsilon_time", "epsilon",
+									 "learning_rate", "seed"} );
+		
+		std::size_t memory = get_count( node, path, "memory", 100000 );
+		Config config( inputs, actions, memory );
+		
+		std::size_t batch = get_count( node, path, "batch_size", config.batch_size() );
+		if( batch == 0 || batch > memory )
+			fail( child_path( path, "batch_size" ), "has to be positive and at most the memory size" );
+		std::size_t init_memory = get_count( node, path, "init_memory_size", config.init_memory_size() );
+		if( init_memory > memory )
+			fail( child_path( path, "init_memory_size" ), "exceeds the memory size" );
+		double gamma = get_number( node, path, "discount_factor", config.gamma() );
+		check_range( gamma, 0, 1, child_path( path, "discount_factor" ) );
+		std::size_t interval = get_count( node, path, "update_interval", config.update_interval() );
+		if( interval == 0 )
+			fail( child_path( path, "update_interval" ), "has to be positive" );
+		
+		config.batch_size( batch )
+			  .steps_per_batch( get_count( node, path, "steps_per_batch", 4 ) )
+			  .discount_factor( gamma )
+			  .update_interval( interval )
+			  .init_memory_size( init_memory )
+			  .seed( get_count( node, path, "seed", config.seed() ) );
+		
+		if( const ptree* steps = find( node, "epsilon_steps" ) )
+			config.epsilon_steps( to_count( *steps, child_path( path, "epsilon_steps" ) ) );
+		if( const ptree* start = find( node, "init_epsilon_time" ) )
+			config.init_epsilon_time( to_count( *start, child_path( path, "init_epsilon_time" ) ) );
+		if( const ptree* eps = find( node, "epsilon" ) )
+		{
+			if( find( node, "epsilon_steps" ) || find( node, "init_epsilon_time" ) )
+				fail( child_path( path, "epsilon" ), "cannot be combined with epsilon_steps or init_epsilon_time" );
+			config.epsilon( parse_schedule( *eps, child_path( path, "epsilon" ) ) );
+		}
+		if( const ptree* tau = find( node, "target_tau" ) )
+		{
+			Schedule schedule = parse_schedule( *tau, child_path( path, "target_tau" ) );
+			check_range( schedule( 0 ), 0, 1, child_path( path, "target_tau" ) );
+			config.target_tau( std::move(schedule) );
+		}
+		if( const ptree* rate = find( node, "learning_rate" ) )
+			config.learning_rate( parse_schedule( *rate, child_path( path, "learning_rate" ) ) );
+		return config;
+	}
+	
+	// the layer type of an entry of a layer list, which is either a plain string or an object with a type
+	std::string layer_type( const ptree& node, const std::string& path )
+	{
+		return is_value( node ) ? node.data() : require( node, path, "type" ).data();
+	}
+	
+	net::Network build_network( const ptree& node, const std::string& path, std::size_t inputs, util::Random& random );
+	
+	// appends the layer described by node to network and returns its output size
+	std::size_t build_layer( net::Network& network, const ptree& node, const std::string& path, std::size_t inputs, util::Random& random )
+	{
+		std::string type = layer_type( node, path );
+		if( type == "fc" )
+		{
+			check_keys( node, path, {"type", "size", "scale"} );
+			std::size_t size = to_count( require( node, path, "size" ), child_path( path, "size" ) );
+			if( size == 0 )
+				fail( child_path( path, "size" ), "has to be positive" );
+			double scale = get_number( node, path, "scale", 1 / std::sqrt( (double)inputs ) );
+			Matrix weights( size, inputs );
+			for(Eigen::Index i = 0; i < weights.size(); ++i)
+				weights.data()[i] = (2 * random.uniform() - 1) * scale;
+			network << net::FcLayer( std::move(weights) );
+			return size;
+		} else if( type == "relu" || type == "tanh" )
+		{
+			if( !is_value( node ) )
+				check_keys( node, path, {"type"} );
+			if( type == "relu" )
+				network << net::ReLULayer( Matrix::Zero(inputs, 1) );
+			else
+				network << net::TanhLayer( Matrix::Zero(inputs, 1) );
+			return inputs;
+		} else if( type == "dueling" )
+		{
+			check_keys( node, path, {"type", "value", "advantage"} );
+			auto value = build_network( require( node, path, "value" ), child_path( path, "value" ), inputs, random );
+			auto advantage = build_network( require( node, path, "advantage" ), child_path( path, "advantage" ), inputs, random );
+			if( value.getOutputSize() != 1 )
+				fail( child_path( path, "value" ), "has to have a single output" );
+			std::size_t actions = advantage.getOutputSize();
+			network << net::DuelingHead( std::move(value), std::move(advantage) );
+			return actions;
+		}
+		fail( path, "unknown layer type '" + type + "'" );
+	}
+	
+	net::Network build_network( const ptree& node, const std::string& path, std::size_t inputs, util::Random& random )
+	{
+		auto layers = get_list( node, path );
+		if( layers.empty() )
+			fail( path, "needs at least one layer" );
+		net::Network network;
+		for(std::size_t i = 0; i < layers.size(); ++i)
+			inputs = build_layer( network, *layers[i], index_path( path, i ), inputs, random );
+		return network;
+	}
+	
+	net::Network build_network( const ptree& root, std::uint64_t seed )
+	{
+		util::Random random( seed, 1 );
+		std::size_t inputs = to_count( require( root, "", "inputs" ), "inputs" );
+		std::size_t actions = to_count( require( root, "", "actions" ), "actions" );
+		auto network = build_network( require( root, "", "network" ), "network", inputs, random );
+		if( network.getOutputSize() != actions )
+			fail( "network", "has " + std::to_string( network.getOutputSize() ) + " outputs, but there are "
+				  + std::to_string( actions ) + " actions" );
+		return network;
+	}
+	
+	void check_optimizer( const ptree& root )
+	{
+		const ptree* node = find( root, "optimizer" );
+		if( !node )
+			return;
+		check_keys( *node, "optimizer", {"type", "decay", "rate", "epsilon", "state"} );
+		std::string type = require( *node, "optimizer", "type" ).data();
+		if( type != "rmsprop" )
+			fail( "optimizer.type", "unknown optimizer '" + type + "'" );
+		check_range( get_number( *node, "optimizer", "decay", DEFAULT_DECAY ), 0, 1, "optimizer.decay" );
+		if( get_number( *node, "optimizer", "rate", DEFAULT_RATE ) <= 0 )
+			fail( "optimizer.rate", "has to be positive" );
+		if( get_number( *node, "optimizer", "epsilon", DEFAULT_EPSILON ) <= 0 )
+			fail( "optimizer.epsilon", "has to be positive" );
+		std::string state = node->get( "state", "float" );
+		if( state != "float" && state != "double" )
+			fail( "optimizer.state", "has to be \"float\" or \"double\"" );
+	}
+	
+	// the entry at path, e.g. "network[2].size", which is created if it is missing
+	ptree& get_entry( ptree& root, const std::string& path )
+	{
+		ptree* node = &root;
+		std::size_t begin = 0;
+		while( begin <= path.size() )
+		{
+			std::size_t end = std::min( path.find( '.', begin ), path.size() );
+			std::string part = path.substr( begin, end - begin );
+			std::size_t bracket = part.find( '[' );
+			std::string key = part.substr( 0, bracket );
+			if( key.empty() )
+				fail( path, "invalid path" );
+			
+			auto found = node->find( key );
+			node = found == node->not_found() ? &node->push_back( {key, ptree()} )->second : &found->second;
+			
+			while( bracket != std::string::npos )
+			{
+				std::size_t close = part.find( ']', bracket );
+				if( close == std::string::npos )
+					fail( path, "invalid path" );
+				std::size_t index = std::strtoul( part.c_str() + bracket + 1, nullptr, 10 );
+				if( index >= node->size() || !node->begin()->first.empty() )
+					fail( path, "there is no entry " + std::to_string(index) );
+				auto entry = node->begin();
+				std::advance( entry, index );
+				node = &entry->second;
+				bracket = part.find( '[', close );
+			}
+			begin = end + 1;
+		}
+		return *node;
+	}
+	
+	ThreadLayout parse_threads( const ptree& root )
+	{
+		ThreadLayout layout;
+		const ptree* node = find( root, "threads" );
+		if( !node )
+			return layout;
+		check_keys( *node, "threads", {"count", "cores"} );
+		layout.threads = get_count( *node, "threads", "count", 1 );
+		if( layout.threads == 0 )
+			fail( "threads.count", "has to be positive" );
+		if( const ptree* cores = find( *node, "cores" ) )
+		{
+			auto list = get_list( *cores, "threads.cores" );
+			unsigned available = std::thread::hardware_concurrency();
+			for(std::size_t i = 0; i < list.size(); ++i)
+			{
+				std::size_t core = to_count( *list[i], index_path( "threads.cores", i ) );
+				if( available > 0 && core >= available )
+					fail( index_path( "threads.cores", i ), "there are only " + std::to_string(available) + " cores" );
+				layout.cores.push_back( (int)core );
+			}
+		}
+		return layout;
+	}
+}
+	
+	Experiment::Experiment( boost::property_tree::ptree description ) :
+		mDescription( std::move(description) ),
+		mConfig( parse_config( mDescription ) ),
+		mThreads( parse_threads( mDescription ) )
+	{
+		check_keys( mDescription, "", {"game", "inputs", "actions", "learner", "network", "optimizer", "threads"} );
+		if( const ptree* game = find( mDescription, "game" ) )
+			mGame = game->data();
+		check_optimizer( mDescription );
+		// building the network once checks its layers and shapes
+		build_network( mDescription, 0 );
+	}
+	
+	Experiment Experiment::fromFile( const std::string& path )
+	{
+		ptree description;
+		try
+		{
+			boost::property_tree::read_json( path, description );
+		} catch( boost::property_tree::json_parser_error& e )
+		{
+			throw std::runtime_error( e.what() );
+		}
+		return Experiment( std::move(description) );
+	}
+	
+	Experiment Experiment::fromString( const std::string& json )
+	{
+		std::istringstream stream( json );
+		ptree description;
+		try
+		{
+			boost::property_tree::read_json( stream, description );
+		} catch( boost::property_tree::json_parser_error& e )
+		{
+			throw std::runtime_error( e.what() );
+		}
+		return Experiment( std::move(description) );
+	}
+	
+	Experiment Experiment::with( const std::vector<override_t>& overrides ) const
+	{
+		ptree description = mDescription;
+		for(const auto& entry : overrides)
+		{
+			ptree& node = get_entry( description, entry.first );
+			// a plain value also replaces an object, e.g. a schedule
+			node = ptree( entry.second );
+		}
+		return Experiment( std::move(description) );
+	}
+	
+	net::Network Experiment::makeNetwork( std::uint64_t seed ) const
+	{
+		return build_network( mDescription, seed );
+	}
+	
+	std::unique_ptr<net::Solver> Experiment::makeSolver() const
+	{
+		static const ptree empty;
+		const ptree* found = find( mDescription, "optimizer" );
+		const ptree& node = found ? *found : empty;
+		double decay = get_number( node, "optimizer", "decay", DEFAULT_DECAY );
+		double rate = get_number( node, "optimizer", "rate", DEFAULT_RATE );
+		double epsilon = get_number( node, "optimizer", "epsilon", DEFAULT_EPSILON );
+		// by default, the state has the precision of the parameters
+		std::string state = node.get( "state", "" );
+		if( state == "double" )
+			return std::make_unique<net::Solver>( std::make_unique<net::BasicRMSProp<double>>( decay, rate, epsilon ) );
+		if( state == "float" )
+			return std::make_unique<net::Solver>( std::make_unique<net::BasicRMSProp<float>>( decay, rate, epsilon ) );
+		return std::make_unique<net::Solver>( std::make_unique<net::RMSProp>( decay, rate, epsilon ) );
+	}
+	
+	double Experiment::initialLearningRate() const
+	{
+		if( mConfig.learning_rate() )
+			return mConfig.learning_rate()( 0 );
+		const ptree* node = find( mDescription, "optimizer" );
+		return node ? get_number( *node, "optimizer", "rate", DEFAULT_RATE ) : DEFAULT_RATE;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+
+#include "qconfig.hpp"
+
+class Game;
+
+namespace net
+{
+	class Network;
+	class Solver;
+}
+
+namespace qlearn
+{
+	// how the threads of a run are laid out. An empty core list means no pinning.
+	struct ThreadLayout
+	{
+		std::size_t threads = 1;
+		std::vector<int> cores;
+	};
+	
+	/*! \class Experiment
+		\brief Declarative description of a training run, loaded from a JSON file.
+		\details Describes the problem size, the Config hyperparameters, the layer stack of the network,
+				the optimizer and the thread layout. The whole description is validated when the experiment
+				is created, so that errors show up before any training starts. Errors are reported as
+				std::invalid_argument with the path of the offending entry, e.g. "network[2].size".
+				Unknown keys are rejected, so that typos do not silently fall back to defaults.
+				
+				\code
+				{
+					"game": "pong",
+					"inputs": 30, "actions": 3,
+					"learner": { "memory": 200000, "batch_size": 32, "discount_factor": 0.98,
+								 "epsilon": { "type": "linear", "start": 1, "end": 0.1, "steps": 2000000 } },
+					"network": [ { "type": "fc", "size": 30 }, "tanh", { "type": "fc", "size": 3 }, "tanh" ],
+					"optimizer": { "type": "rmsprop", "decay": 0.95, "rate": 0.0001, "epsilon": 1e-6 },
+					"threads": { "count": 2, "cores": [0, 1] }
+				}
+				\endcode
+				
+				Layers are "fc" (with "size" and an optional initialization "scale"), "relu", "tanh" and
+				"dueling" (with "value" and "advantage" layer lists). Schedules are either numbers or objects of
+				type "constant", "linear", "exponential", "cosine" or "piecewise", see Schedule.
+				The optimizer keeps its running means in "float" or "double", as given by "state".
+	*/
+	class Experiment
+	{
+	public:
+		explicit Experiment( boost::property_tree::ptree description );
+		
+		// Throws std::invalid_argument if the description is invalid, and std::runtime_error if the
+		// file cannot be read or is not valid JSON.
+		static Experiment fromFile( const std::string& path );
+		static Experiment fromString( const std::string& json );
+		
+		const Config& config() const { return mConfig; }
+		const ThreadLayout& threads() const { return mThreads; }
+		// name of the environment, may be empty
+		const std::string& game() const { return mGame; }
+		
+		// a new network with freshly initialized parameters
+		net::Network makeNetwork( std::uint64_t seed ) const;
+		// a new solver with the configured update rule
+		std::unique_ptr<net::Solver> makeSolver() const;
+		// the learning rate at the start, from the learning rate schedule or the optimizer
+		double initialLearningRate() const;
+		
+		// the parsed description
+		const boost::property_tree::ptree& description() const { return mDescription; }
+		
+		using override_t = std::pair<std::string, std::string>;
+		// a copy of this experiment with some entries replaced, e.g. {"learner.batch_size", "64"}. Entries
+		// of lists are addressed by their index, e.g. "network[2].size". Missing objects and keys are
+		// created. The result is validated like a newly loaded experiment.
+		Experiment with( const std::vector<override_t>& overrides ) const;
+		
+	private:
+		boost::property_tree::ptree mDescription;
+		Config mConfig;
+		ThreadLayout mThreads;
+		std::string mGame;
+	};
+	
+	// creates the environment for an experiment
+	using game_factory_t = std::function<std::unique_ptr<Game>( const Experiment& experiment, std::uint64_t seed )>;
+}
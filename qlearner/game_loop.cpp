@@ -0,0 +1,52 @@
+#include "game_loop.hpp"
+#include "qlearner.hpp"
+#include "games/game.h"
+#include "util/affinity.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+
+namespace qlearn
+{
+	GameLoop::GameLoop( Game& game, QLearner& learner, net::Solver& solver ) :
+		mGame( game ), mLearner( learner ), mSolver( solver )
+	{
+		mGame.restart();
+		mGame.getCurrentState( mState );
+		const Config& config = mLearner.config();
+		if( (std::size_t)mState.size() != config.input_size() || (std::size_t)mGame.getNumInputs() != config.action_count() )
+			throw std::invalid_argument("inputs and actions do not match the game");
+	}
+	
+	void GameLoop::step()
+	{
+		float reward = mGame.step( mAction );
+		bool terminal = mGame.isFinished();
+		mGame.getCurrentState( mState );
+		mAction = mLearner.learn_step( mState, reward, terminal || reward != 0, mSolver );
+		if( terminal )
+			mGame.restart();
+	}
+	
+	void run_pinned( std::size_t count, std::size_t workers, const std::vector<std::vector<int>>& groups,
+					 const std::function<void(std::size_t)>& task )
+	{
+		assert( !groups.empty() );
+		workers = std::max<std::size_t>( 1, std::min( workers, count ) );
+		std::atomic<std::size_t> next{0};
+		auto work = [&]( std::size_t worker )
+		{
+			util::pin_current_thread( groups[worker % groups.size()] );
+			for(std::size_t i = next++; i < count; i = next++)
+				task( i );
+		};
+		
+		std::vector<std::thread> threads;
+		for(std::size_t w = 0; w < workers; ++w)
+			threads.emplace_back( work, w );
+		for(auto& thread : threads)
+			thread.join();
+	}
+}
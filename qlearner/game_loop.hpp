@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "config.h"
+
+class Game;
+
+namespace net
+{
+	class Solver;
+}
+
+namespace qlearn
+{
+	class QLearner;
+	
+	/*! \class GameLoop
+		\brief Lets a QLearner play a game, for headless training such as sweeps and populations.
+		\details Each step feeds the reward and the new state of the game to learn_step, and plays the
+				returned action in the next step. The game is restarted when it is finished, and, as in
+				the drivers, every reward also ends a Q-learning episode.
+				Game, learner and solver are not owned and have to outlive the loop.
+	*/
+	class GameLoop
+	{
+	public:
+		// restarts game. Throws std::invalid_argument if its state size or action count do not match the
+		// config of learner.
+		GameLoop( Game& game, QLearner& learner, net::Solver& solver );
+		
+		// one environment step followed by one learning step
+		void step();
+		
+	private:
+		Game& mGame;
+		QLearner& mLearner;
+		net::Solver& mSolver;
+		Vector mState;
+		int mAction = 0;
+	};
+	
+	// runs task(i) for every i < count on up to workers threads. Worker w is pinned to the core group
+	// groups[w % groups.size()], and takes the next task as soon as it has finished one. Blocks until all
+	// tasks are done. groups must not be empty.
+	void run_pinned( std::size_t count, std::size_t workers, const std::vector<std::vector<int>>& groups,
+					 const std::function<void(std::size_t)>& task );
+}
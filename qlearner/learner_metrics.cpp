@@ -0,0 +1,44 @@
+#include "learner_metrics.hpp"
+#include "qlearner.hpp"
+#include "stats.h"
+#include "util/metrics.hpp"
+
+namespace qlearn
+{
+	LearnerMetrics::LearnerMetrics( metrics::Registry& registry, std::size_t memory_capacity ) : 
+		mMemoryCapacity( memory_capacity ),
+		mEnvSteps( registry.counter( "dqn_env_steps_total", "environment steps" ) ),
+		mLearnSteps( registry.counter( "dqn_learn_steps_total", "learning steps (minibatch updates)" ) ),
+		mEpisodeCount( registry.counter( "dqn_episodes_total", "finished episodes" ) ),
+		mReplayFill( registry.gauge( "dqn_replay_fill_ratio", "fill level of the replay memory" ) ),
+		mEpsilon( registry.gauge( "dqn_epsilon", "current exploration rate" ) ),
+		mReturn( registry.gauge( "dqn_episode_return_mean", "mean return of the recent episodes" ) ),
+		mReward( registry.gauge( "dqn_reward_mean", "mean reward per step over the stats window" ) ),
+		mError( registry.gauge( "dqn_learn_error_mean", "mean squared TD error over the stats window" ) ),
+		mLatency( registry.histogram( "dqn_learn_step_seconds", "duration of learn_step",
+									  metrics::exponentialBuckets( 1e-6, 2, 20 ) ) )
+	{
+	}
+	
+	void LearnerMetrics::step( const QLearner& learner, double seconds )
+	{
+		mEnvSteps.add();
+		mLatency.observe( seconds );
+		if( ++mSteps % UPDATE_INTERVAL != 0 )
+			return;
+		
+		std::uint64_t learning_steps = learner.getLearningSteps();
+		mLearnSteps.add( learning_steps - mLearningSteps );
+		mLearningSteps = learning_steps;
+		
+		StatsSnapshot stats = learner.getStats().snapshot();
+		mEpisodeCount.add( stats.episodes - mEpisodes );
+		mEpisodes = stats.episodes;
+		
+		mReplayFill.set( double(learner.getMemorySize()) / mMemoryCapacity );
+		mEpsilon.set( learner.getCurrentEpsilon() );
+		mReturn.set( stats.return_mean );
+		mReward.set( stats.reward_mean );
+		mError.set( stats.error_mean );
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace metrics
+{
+	class Registry;
+	class Counter;
+	class Gauge;
+	class Histogram;
+}
+
+namespace qlearn
+{
+	class QLearner;
+	
+	/*! \class LearnerMetrics
+		\brief Registers the standard training metrics of a QLearner and keeps them up to date.
+		\details Call step() after every learn_step. Counters and the latency histogram are updated
+				on every step, the values derived from the replay memory and the stats snapshot only
+				every UPDATE_INTERVAL steps. All updates are relaxed atomic stores, so exporting the
+				metrics never blocks the learner.
+	*/
+	class LearnerMetrics
+	{
+	public:
+		static const std::uint64_t UPDATE_INTERVAL = 1000;
+		
+		// memory_capacity is used to report the fill level of the replay memory
+		LearnerMetrics( metrics::Registry& registry, std::size_t memory_capacity );
+		
+		// records one environment step, whose learn_step took seconds
+		void step( const QLearner& learner, double seconds );
+		
+	private:
+		std::size_t mMemoryCapacity;
+		std::uint64_t mSteps = 0;
+		std::uint64_t mLearningSteps = 0;
+		std::uint64_t mEpisodes = 0;
+		
+		metrics::Counter& mEnvSteps;
+		metrics::Counter& mLearnSteps;
+		metrics::Counter& mEpisodeCount;
+		metrics::Gauge& mReplayFill;
+		metrics::Gauge& mEpsilon;
+		metrics::Gauge& mReturn;
+		metrics::Gauge& mReward;
+		metrics::Gauge& mError;
+		metrics::Histogram& mLatency;
+	};
+}
@@ -1,9 +1,65 @@
 #include "memory.hpp"
+#include "net/mapped_file.hpp"
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 namespace qlearn 
 {
+namespace
+{
+	const char MEMORY_MAGIC[8] = {'D', 'Q', 'N', 'M', 'E', 'M', '\0', '\0'};
+	const std::uint32_t MEMORY_VERSION = 1;
+	
+	// the header is followed by count records of
+	// situation[state_size], future[state_size] (number_t), reward (float), action (int32), terminal (uint32)
+	struct MemoryHeader
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t scalar_size;
+		std::uint64_t state_size;
+		std::uint64_t count;
+	};
+	
+	std::size_t recordSize( std::size_t state_size )
+	{
+		return 2 * state_size * sizeof(number_t) + sizeof(float) + 2 * sizeof(std::uint32_t);
+	}
+	
+	MemoryHeader makeHeader( const boost::circular_buffer<Experience>& memory )
+	{
+		MemoryHeader header;
+		std::memcpy( header.magic, MEMORY_MAGIC, sizeof(MEMORY_MAGIC) );
+		header.version = MEMORY_VERSION;
+		header.scalar_size = sizeof(number_t);
+		header.state_size = memory.empty() ? 0 : memory.front().situation.size();
+		header.count = memory.size();
+		return header;
+	}
+	
+	// writes exp as a record of recordSize(state_size) bytes to out
+	void writeRecord( const Experience& exp, std::size_t state_size, char* out )
+	{
+		if( (std::size_t)exp.situation.size() != state_size || (std::size_t)exp.future.size() != state_size )
+			throw std::runtime_error("cannot save memory with experiences of different size");
+		
+		const std::size_t vec_bytes = state_size * sizeof(number_t);
+		std::int32_t action = exp.action;
+		std::uint32_t terminal = exp.terminal;
+		std::memcpy( out, exp.situation.data(), vec_bytes );
+		std::memcpy( out + vec_bytes, exp.future.data(), vec_bytes );
+		std::memcpy( out + 2 * vec_bytes, &exp.reward, sizeof(float) );
+		std::memcpy( out + 2 * vec_bytes + sizeof(float), &action, sizeof(action) );
+		std::memcpy( out + 2 * vec_bytes + sizeof(float) + sizeof(action), &terminal, sizeof(terminal) );
+	}
+}
+
 MemoryCache::MemoryCache( std::size_t capacity )
 {
 	mMemory.set_capacity( capacity );
@@ -36,4 +92,84 @@ const Experience& MemoryCache::get( std::size_t index ) const
 	assert(index  < mMemory.size());
 	return mMemory[index];
 }
+
+void MemoryCache::save( const std::string& path ) const
+{
+	MemoryHeader header = makeHeader( mMemory );
+	
+	// the experiences are streamed through a fixed size buffer, so saving needs no memory proportional to the cache
+	std::string temp = path + ".tmp";
+	std::ofstream file( temp, std::ios::binary | std::ios::trunc );
+	if( !file )
+		throw std::runtime_error("could not open " + temp);
+	file.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+	
+	const std::size_t record_size = recordSize( header.state_size );
+	std::vector<char> chunk( std::max<std::size_t>( 1 << 20, record_size ) );
+	std::size_t used = 0;
+	for(const auto& exp : mMemory)
+	{
+		if( used + record_size > chunk.size() )
+		{
+			file.write( chunk.data(), used );
+			used = 0;
+		}
+		writeRecord( exp, header.state_size, chunk.data() + used );
+		used += record_size;
+	}
+	file.write( chunk.data(), used );
+	file.close();
+	
+	if( !file )
+		throw std::runtime_error("could not write " + temp);
+	if( std::rename( temp.c_str(), path.c_str() ) != 0 )
+		throw std::runtime_error("could not rename " + temp + " to " + path);
+}
+
+void MemoryCache::serialize( std::vector<char>& buffer ) const
+{
+	MemoryHeader header = makeHeader( mMemory );
+	const std::size_t record_size = recordSize( header.state_size );
+	buffer.resize( sizeof(header) + mMemory.size() * record_size );
+	std::memcpy( buffer.data(), &header, sizeof(header) );
+	char* out = buffer.data() + sizeof(header);
+	for(const auto& exp : mMemory)
+	{
+		writeRecord( exp, header.state_size, out );
+		out += record_size;
+	}
+}
+
+void MemoryCache::load( const std::string& path )
+{
+	net::MappedFile file( path );
+	const MemoryHeader& header = *file.at<MemoryHeader>( 0 );
+	if( std::memcmp( header.magic, MEMORY_MAGIC, sizeof(MEMORY_MAGIC) ) != 0 || header.version != MEMORY_VERSION ||
+		header.scalar_size != sizeof(number_t) )
+	{
+		throw std::runtime_error(path + " is not a compatible memory file");
+	}
+	
+	const std::size_t record_size = recordSize( header.state_size );
+	const char* records = file.at<char>( sizeof(MemoryHeader), header.count * record_size );
+	
+	// only the newest experiences survive if the capacity is too small, so skip the others right away
+	std::size_t first = header.count > capacity() ? header.count - capacity() : 0;
+	Vector situation( header.state_size );
+	Vector future( header.state_size );
+	const std::size_t vec_bytes = header.state_size * sizeof(number_t);
+	for(std::size_t i = first; i < header.count; ++i)
+	{
+		const char* rec = records + i * record_size;
+		float reward;
+		std::int32_t action;
+		std::uint32_t terminal;
+		std::memcpy( situation.data(), rec, vec_bytes );
+		std::memcpy( future.data(), rec + vec_bytes, vec_bytes );
+		std::memcpy( &reward, rec + 2 * vec_bytes, sizeof(reward) );
+		std::memcpy( &action, rec + 2 * vec_bytes + sizeof(float), sizeof(action) );
+		std::memcpy( &terminal, rec + 2 * vec_bytes + sizeof(float) + sizeof(action), sizeof(terminal) );
+		emplace( situation, action, future, reward, terminal != 0 );
+	}
+}
 }
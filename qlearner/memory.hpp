@@ -1,6 +1,9 @@
 #pragma once
 
 #include "config.h"
+#include "net/checkpoint_writer.hpp"
+#include "util/random.hpp"
+#include <string>
 #include <boost/circular_buffer.hpp>
 
 namespace qlearn 
@@ -14,7 +17,7 @@ struct Experience
 	bool terminal;
 };
 
-class MemoryCache
+class MemoryCache : public net::ISnapshot
 {
 public:
 	MemoryCache( std::size_t capacity );
@@ -28,10 +31,22 @@ public:
 	
 	const Experience& get( std::size_t index ) const;
 	
-	template<class T>
-	const Experience& get_random( T& random );
+	const Experience& get_random( util::Random& random );
 	
 	std::size_t size() const { return mMemory.size(); }
+	std::size_t capacity() const { return mMemory.capacity(); }
+	
+	// writes all experiences, oldest first, to a binary file at path. Throws std::runtime_error on failure.
+	void save( const std::string& path ) const;
+	
+	// copies the contents of the file written by save into buffer, e.g. for AsyncCheckpointWriter.
+	// Does not allocate if buffer already has sufficient capacity.
+	void serialize( std::vector<char>& buffer ) const override;
+	
+	// pushes all experiences from a file written by save, in their original order. If the capacity
+	// is smaller than the number of saved experiences, only the newest ones are kept.
+	// Throws std::runtime_error if the file is invalid.
+	void load( const std::string& path );
 private:
 	boost::circular_buffer<Experience> mMemory;
 	
@@ -39,10 +54,8 @@ private:
 };
 
 
-template<class T>
-const Experience& MemoryCache::get_random( T& random )
+inline const Experience& MemoryCache::get_random( util::Random& random )
 {
-	std::size_t sample = std::uniform_int_distribution<std::size_t>(0, mMemory.size() - 1)(random);
-	return get(sample);
+	return get( random.uniform_int( mMemory.size() ) );
 }
 }
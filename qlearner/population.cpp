@@ -0,0 +1,168 @@
+#include "population.hpp"
+#include "game_loop.hpp"
+#include "qlearner.hpp"
+#include "stats.h"
+#include "net/network.hpp"
+#include "net/solver.hpp"
+#include "games/game.h"
+#include "util/affinity.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+
+namespace qlearn
+{
+	struct PopulationTrainer::Member
+	{
+		std::size_t id;
+		Config config;
+		std::unique_ptr<Game> game;
+		std::unique_ptr<QLearner> learner;
+		std::unique_ptr<net::Solver> solver;
+		std::unique_ptr<GameLoop> loop;
+		
+		double learning_rate;
+		double discount_factor;
+		std::size_t copies = 0;		// how often the member was replaced
+		std::size_t parent;			// the member it was last copied from
+	};
+	
+	PopulationTrainer::PopulationTrainer( Experiment base, game_factory_t factory, PopulationOptions options ) :
+		mBase( std::move(base) ), mFactory( std::move(factory) ), mOptions( std::move(options) )
+	{
+		if( mOptions.interval == 0 )
+			throw std::invalid_argument("population interval has to be positive");
+		if( mOptions.perturbation < 1 )
+			throw std::invalid_argument("population perturbation factor has to be at least 1");
+	}
+	
+	PopulationTrainer::~PopulationTrainer() = default;
+	
+	void PopulationTrainer::run( const std::vector<Trial>& members )
+	{
+		mMembers.clear();
+		mRandom = util::Random( mOptions.seed );
+		for(std::size_t i = 0; i < members.size(); ++i)
+		{
+			Experiment experiment = mBase.with( members[i].values );
+			auto member = std::make_unique<Member>( Member{ i, experiment.config() } );
+			// every member explores with its own random numbers
+			member->config.seed( util::stream_key( experiment.config().seed(), i ) );
+			member->game = mFactory( experiment, member->config.seed() );
+			member->learner = std::make_unique<QLearner>( member->config, experiment.makeNetwork( member->config.seed() ) );
+			member->solver = experiment.makeSolver();
+			member->parent = i;
+			if( !mMembers.empty() && !member->learner->network().is_compatible( mMembers.front()->learner->network() ) )
+				throw std::invalid_argument("all members of a population need the same network structure");
+			
+			member->loop = std::make_unique<GameLoop>( *member->game, *member->learner, *member->solver );
+			
+			setHyperparameters( *member, experiment.initialLearningRate(), experiment.config().gamma() );
+			mMembers.push_back( std::move(member) );
+		}
+		if( mMembers.empty() )
+			return;
+		
+		std::size_t workers = mOptions.workers > 0 ? mOptions.workers : mBase.threads().threads;
+		auto groups = util::split_cores( mOptions.cores.empty() ? mBase.threads().cores : mOptions.cores, 1 );
+		
+		for(std::size_t done = 0; done < mOptions.steps; )
+		{
+			std::size_t steps = std::min( mOptions.interval, mOptions.steps - done );
+			run_pinned( mMembers.size(), workers, groups, [&]( std::size_t i )
+			{
+				for(std::size_t step = 0; step < steps; ++step)
+					mMembers[i]->loop->step();
+			} );
+			
+			done += steps;
+			if( done < mOptions.steps )
+				exploit();
+		}
+	}
+	
+	void PopulationTrainer::exploit()
+	{
+		std::size_t count = std::min<std::size_t>( mOptions.truncation * mMembers.size(), mMembers.size() / 2 );
+		if( count == 0 )
+			return;
+		
+		// best first
+		std::vector<std::size_t> ranking( mMembers.size() );
+		std::iota( ranking.begin(), ranking.end(), 0 );
+		std::stable_sort( ranking.begin(), ranking.end(), [this]( std::size_t a, std::size_t b ) { return getReward( a ) > getReward( b ); } );
+		
+		auto perturb = [this]() { return mRandom.bernoulli( 0.5 ) ? mOptions.perturbation : 1 / mOptions.perturbation; };
+		for(std::size_t i = mMembers.size() - count; i < mMembers.size(); ++i)
+		{
+			Member& member = *mMembers[ranking[i]];
+			const Member& source = *mMembers[ranking[mRandom.uniform_int( count )]];
+			member.learner->copy_parameters_from( *source.learner, *member.solver, *source.solver );
+			++member.copies;
+			member.parent = source.id;
+			// the discount factor is perturbed through its horizon 1 / (1 - gamma)
+			double gamma = 1 - (1 - source.discount_factor) * perturb();
+			setHyperparameters( member, source.learning_rate * perturb(), std::min( std::max( gamma, 0.0 ), 1.0 ) );
+		}
+	}
+	
+	void PopulationTrainer::setHyperparameters( Member& member, double rate, double gamma )
+	{
+		member.learning_rate = rate;
+		member.discount_factor = gamma;
+		member.config.learning_rate( rate ).discount_factor( gamma );
+		member.learner->setConfig( member.config );
+	}
+	
+	const QLearner& PopulationTrainer::getLearner( std::size_t member ) const
+	{
+		return *mMembers.at( member )->learner;
+	}
+	
+	const net::Solver& PopulationTrainer::getSolver( std::size_t member ) const
+	{
+		return *mMembers.at( member )->solver;
+	}
+	
+	double PopulationTrainer::getReward( std::size_t member ) const
+	{
+		return mMembers.at( member )->learner->getStats().getSmoothReward();
+	}
+	
+	double PopulationTrainer::getLearningRate( std::size_t member ) const
+	{
+		return mMembers.at( member )->learning_rate;
+	}
+	
+	double PopulationTrainer::getDiscountFactor( std::size_t member ) const
+	{
+		return mMembers.at( member )->discount_factor;
+	}
+	
+	std::size_t PopulationTrainer::getBest() const
+	{
+		if( mMembers.empty() )
+			throw std::logic_error("the population is empty");
+		std::size_t best = 0;
+		for(std::size_t i = 1; i < mMembers.size(); ++i)
+		{
+			if( getReward( i ) > getReward( best ) )
+				best = i;
+		}
+		return best;
+	}
+	
+	void PopulationTrainer::writeTable( std::ostream& out ) const
+	{
+		out << "member,learning_rate,discount_factor,reward,copies,parent\n";
+		char line[256];
+		for(const auto& member : mMembers)
+		{
+			std::snprintf( line, sizeof(line), "%zu,%.9g,%.9g,%.9g,%zu,%zu\n", member->id, member->learning_rate,
+						   member->discount_factor, getReward( member->id ), member->copies, member->parent );
+			out << line;
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "experiment.hpp"
+#include "sweep.hpp"
+#include "util/random.hpp"
+
+namespace net
+{
+	class Solver;
+}
+
+namespace qlearn
+{
+	class QLearner;
+	
+	struct PopulationOptions
+	{
+		std::size_t steps = 1000000;	// environment steps per member
+		// steps between two rounds of exploit and explore. Should be longer than the reward window of Stats, so
+		// that members are ranked by the performance of their current parameters.
+		std::size_t interval = 20000;
+		double truncation = 0.25;		// fraction of members that is replaced by copies of the best ones
+		double perturbation = 1.2;		// copied hyperparameters are multiplied or divided by this factor
+		std::uint64_t seed = 0;			// for choosing sources and perturbations
+		std::size_t workers = 0;		// concurrent members, 0 uses the thread count of the experiment
+		std::vector<int> cores;			// cores to run on, empty uses the experiment's cores or all
+	};
+	
+	/*! \class PopulationTrainer
+		\brief Population based training of concurrently running learners.
+		\details All members train on their own environment, for interval steps at a time, on pinned worker
+				threads. After each interval the members are ranked by their smoothed reward, and the worst
+				ones copy network, target network and optimizer state in place from one of the best ones
+				(exploit). The learning rate and discount factor of the copy are then randomly perturbed
+				(explore), so the population follows a schedule of hyperparameters that is found on the fly.
+				The learning rate of a member is constant between two rounds, which replaces a learning rate
+				schedule of the experiment.
+	*/
+	class PopulationTrainer
+	{
+	public:
+		PopulationTrainer( Experiment base, game_factory_t factory, PopulationOptions options );
+		~PopulationTrainer();
+		
+		// creates one member per trial, e.g. from SearchSpace::sample, and trains them. All trials have to
+		// lead to the same network structure. Throws std::invalid_argument otherwise.
+		void run( const std::vector<Trial>& members );
+		
+		std::size_t size() const { return mMembers.size(); }
+		const QLearner& getLearner( std::size_t member ) const;
+		const net::Solver& getSolver( std::size_t member ) const;
+		double getReward( std::size_t member ) const;
+		double getLearningRate( std::size_t member ) const;
+		double getDiscountFactor( std::size_t member ) const;
+		// the member with the highest smoothed reward
+		std::size_t getBest() const;
+		
+		// one row per member with its hyperparameters, reward and how often it was replaced
+		void writeTable( std::ostream& out ) const;
+		
+	private:
+		struct Member;
+		
+		void exploit();
+		void setHyperparameters( Member& member, double rate, double gamma );
+		
+		Experiment mBase;
+		game_factory_t mFactory;
+		PopulationOptions mOptions;
+		std::vector<std::unique_ptr<Member>> mMembers;
+		util::Random mRandom;
+	};
+}
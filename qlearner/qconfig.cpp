@@ -1,12 +1,13 @@
 #include "qconfig.hpp"
 #include <algorithm>
+#include <stdexcept>
 
 namespace qlearn 
 {
 Config::Config( std::size_t input_size, std::size_t action_count, std::size_t memory_length ) :
 	mInputSize( input_size ), mActionCount( action_count ), mMemoryLength( memory_length )
 {
-	
+	reset_epsilon();
 }
 
 Config& Config::batch_size( std::size_t size )
@@ -33,6 +34,15 @@ Config& Config::update_interval( std::size_t interval )
 	return *this;
 }
 
+Config& Config::target_tau( Schedule tau )
+{
+	// later values are checked by the learner when the schedule is evaluated
+	if( !tau || !valid_tau( tau( 0 ) ) )
+		throw std::invalid_argument("target_tau has to be in [0, 1]");
+	mTargetTau = std::move(tau);
+	return *this;
+}
+
 Config& Config::init_memory_size( std::size_t init_mem )
 {
 	mInitMemorySize = init_mem;
@@ -41,25 +51,55 @@ Config& Config::init_memory_size( std::size_t init_mem )
 
 Config& Config::init_epsilon_time( std::size_t initeps )
 {
+	if( mCustomEpsilon )
+		throw std::invalid_argument("init_epsilon_time cannot be combined with a custom epsilon schedule");
+	mAnnealSet = true;
 	mEpsilonStart = initeps;
+	reset_epsilon();
 	return *this;
 }
  
 Config& Config::epsilon_steps( std::size_t steps )
 {
+	if( mCustomEpsilon )
+		throw std::invalid_argument("epsilon_steps cannot be combined with a custom epsilon schedule");
+	mAnnealSet = true;
 	mEpsilonSteps = steps;
+	reset_epsilon();
 	return *this;
 }
 
-float Config::getStepEpsilon( std::size_t num_step ) const
+Config& Config::seed( std::uint64_t seed )
+{
+	mSeed = seed;
+	return *this;
+}
+
+Config& Config::epsilon( Schedule eps )
+{
+	if( !eps )
+		throw std::invalid_argument("epsilon schedule must not be empty");
+	if( mAnnealSet )
+		throw std::invalid_argument("a custom epsilon schedule cannot be combined with epsilon_steps or init_epsilon_time");
+	mCustomEpsilon = true;
+	mEpsilon = std::move(eps);
+	return *this;
+}
+
+Config& Config::learning_rate( Schedule rate )
+{
+	mLearningRate = std::move(rate);
+	return *this;
+}
+
+void Config::reset_epsilon()
 {
-	if(num_step > mEpsilonSteps + mEpsilonStart)
-		return mFinalEpsilon;
-	if( num_step < mEpsilonStart )
-		return 1;
+	auto anneal = Schedule::linear( 1, mFinalEpsilon, mEpsilonSteps );
+	mEpsilon = mEpsilonStart == 0 ? anneal : Schedule::piecewise({ {0, 1.0}, {mEpsilonStart, anneal} });
+}
 
-	double f = (double)(num_step - mEpsilonStart) / mEpsilonSteps;
-	
-	return mFinalEpsilon * f + (1-f);
+float Config::getStepEpsilon( std::size_t num_step ) const
+{
+	return mEpsilon( num_step );
 }
 }
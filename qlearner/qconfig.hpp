@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include "schedule.hpp"
 
 namespace qlearn
 {
@@ -14,19 +15,38 @@ namespace qlearn
 		Config& steps_per_batch( std::size_t steps );
 		Config& discount_factor( double factor );
 		Config& update_interval( std::size_t interval );
-		Config& epsilon_steps( std::size_t steps );
+		// throws std::invalid_argument if the initial tau is not in [0, 1]
+		Config& target_tau( Schedule tau );
 		Config& init_memory_size( std::size_t init_mem );
+		// these two parametrize the default epsilon schedule, a linear anneal from 1 to the final epsilon
+		Config& epsilon_steps( std::size_t steps );
 		Config& init_epsilon_time( std::size_t initeps );
+		// schedules are evaluated with the number of learning steps. A custom epsilon schedule cannot be
+		// combined with epsilon_steps or init_epsilon_time, mixing them throws std::invalid_argument, as
+		// does an empty schedule.
+		Config& epsilon( Schedule eps );
+		// if set, the learner sets the rate of the solver's update rule in every step
+		Config& learning_rate( Schedule rate );
+		// seed of all random decisions of the learner
+		Config& seed( std::uint64_t seed );
 		
 		// get info
 		float getStepEpsilon( std::size_t num_step ) const;
 		
+		std::size_t input_size() const { return mInputSize; }
 		std::size_t init_memory_size() const { return mInitMemorySize; };
 		std::size_t batch_size() const { return mMiniBatchSize; };
 		std::size_t action_count() const { return mActionCount; }
 		double      gamma() const { return mDiscountFactor; } 
 		std::size_t update_interval(  ) const { return mNetUpdateFrq; }
+		const Schedule& target_tau(  ) const { return mTargetTau; }
+		const Schedule& epsilon(  ) const { return mEpsilon; }
+		const Schedule& learning_rate(  ) const { return mLearningRate; }
 		std::size_t memory(  ) const { return mMemoryLength; }
+		std::uint64_t seed(  ) const { return mSeed; }
+		
+		// 0 means hard target updates, values up to 1 soft updates
+		static bool valid_tau( double tau ) { return tau >= 0 && tau <= 1; }
 	private:
 		// problem config
 		std::size_t mInputSize;
@@ -41,11 +61,20 @@ namespace qlearn
 		std::size_t mMemoryLength;
 		double      mDiscountFactor = 0.9;
 		std::size_t mNetUpdateFrq   = 10000;
+		Schedule    mTargetTau      = 0.0;   // if > 0, soft target updates are used instead of copies every mNetUpdateFrq steps
 		std::size_t mInitMemorySize = 1000;
 		
 		// strategy annealing
 		float       mFinalEpsilon   = 0.1;
 		std::size_t mEpsilonSteps   = 1e6;
 		std::size_t mEpsilonStart   = 1000;
+		Schedule    mEpsilon;
+		bool        mAnnealSet      = false;	// epsilon_steps or init_epsilon_time was called
+		bool        mCustomEpsilon  = false;	// epsilon was called
+		Schedule    mLearningRate;
+		
+		std::uint64_t mSeed         = 0;
+		
+		void reset_epsilon();
 	};
 }
@@ -1,6 +1,7 @@
 #include "qcore.hpp"
 #include "net/computation_graph.hpp"
 #include "memory.hpp"
+#include "util/trace.hpp"
 #include <iostream>
 
 namespace qlearn
@@ -8,7 +9,8 @@ namespace qlearn
 	using namespace net;
 	
 	QCore::QCore( Config cfg ) : mConfig( std::move(cfg) ),
-	mMemory( std::make_unique<MemoryCache>( mConfig.memory() ) )
+	mMemory( std::make_unique<MemoryCache>( mConfig.memory() ) ),
+	mRandom( mConfig.seed() )
 	{
 		mLastStates.set_capacity(3);
 		mLastRewards.set_capacity(3);
@@ -20,8 +22,13 @@ namespace qlearn
 	
 	std::size_t QCore::getRandomAction()
 	{
-		auto ind_dst = std::uniform_int_distribution<int>(0, mConfig.action_count()-1); // this is inclusive, so we need -1
-		return ind_dst(mRandom);
+		return mRandom.uniform_int( mConfig.action_count() );
+	}
+	
+	void QCore::setSteps( std::size_t steps, std::size_t learning_steps )
+	{
+		mStepCounter = steps;
+		mLearningSteps = learning_steps;
 	}
 	
 	float QCore::getEpsilon() const
@@ -31,6 +38,7 @@ namespace qlearn
 	
 	Action QCore::forward( net::ComputationGraph& policy, const Vector& input, bool learning )
 	{
+		DQN_TRACE_SCOPE("QCore::forward");
 		++mStepCounter;
 		float eps = getEpsilon();
 		
@@ -40,8 +48,7 @@ namespace qlearn
 		if(learning)	 mLastStates.push_front( input );
 		
 		// with certain probability choose a random action
-		auto random_action = std::discrete_distribution<int>({eps, 1-eps});
-		if( random_action(mRandom))
+		if( mRandom.bernoulli( eps ) )
 		{
 			Action action;
 			action.id = getRandomAction();
@@ -53,12 +60,13 @@ namespace qlearn
 		{
 			auto ac = getAction( policy, input );
 			if( learning ) mLastActions.push_front( ac.id );
-			return std::move(ac);
+			return ac;
 		}
 	}
 	
 	void QCore::backward( float reward, bool terminal )
 	{
+		DQN_TRACE_SCOPE("QCore::backward");
 		mLastRewards.push_front( reward );
 		mLastTerminal.push_front( terminal );
 		if(mLastStates.size() < 2) return;
@@ -72,10 +80,11 @@ namespace qlearn
 		mMemory->emplace( old_state, old_act, new_state, old_rewd, old_term );
 	}
 	
-	float getTargetQValue(const Experience& experience, ComputationGraph& target_q, float gamma)
+	// computed in accum_t, a float target loses the small differences between close Q-values
+	accum_t getTargetQValue(const Experience& experience, ComputationGraph& target_q, accum_t gamma)
 	{
 		// best value that can be reached from here
-		float y = 0;
+		accum_t y = 0;
 		if( !experience.terminal )
 		{
 			auto best = getAction(target_q, experience.future);
@@ -88,26 +97,38 @@ namespace qlearn
 	
 	float QCore::learn(net::ComputationGraph& policy, net::ComputationGraph& target, Solver& solver)
 	{
+		DQN_TRACE_SCOPE("QCore::learn");
 		// check if we are allowed to learn
 		if(mMemory->size() < mConfig.init_memory_size())
 			return 0;
 	
 		++mLearningSteps;
 		
-		float mse = 0;
+		accum_t mse = 0;
 
 		// train an epoch
 		for(unsigned i = 0; i < mConfig.batch_size(); ++i)
 		{
-			/// \attention this line allocates!
-			const auto& trans = mMemory->get_random(mRandom);
-			float target_value = getTargetQValue( trans, target, mConfig.gamma() );
+			const Experience* trans;
+			{
+				PhaseTimer timer( mTimings, Phase::SAMPLE );
+				trans = &mMemory->get_random(mRandom);
+			}
+			
+			accum_t delta;
+			{
+				PhaseTimer timer( mTimings, Phase::FORWARD );
+				accum_t target_value = getTargetQValue( *trans, target, mConfig.gamma() );
+				const auto& result = policy.forward( trans->situation );
+				mErrorCache = Vector::Zero( result.size() );
+				delta = result[trans->action] - target_value;
+			}
 			
-			const auto& result = policy.forward( trans.situation );
-			mErrorCache = Vector::Zero( result.size() );
-			float delta = result[trans.action] - target_value;
-			mErrorCache[trans.action] = delta;
-			policy.backpropagate(mErrorCache, solver );
+			{
+				PhaseTimer timer( mTimings, Phase::BACKWARD );
+				mErrorCache[trans->action] = static_cast<number_t>( delta );
+				policy.backpropagate(mErrorCache, solver );
+			}
 			mse += delta * delta;
 		}
 		
@@ -7,6 +7,8 @@
 
 #include "qconfig.hpp"
 #include "action.h"
+#include "timings.hpp"
+#include "util/random.hpp"
 
 namespace net
 {
@@ -37,9 +39,21 @@ namespace qlearn
 		// returns mse of minibatch. 
 		float learn(net::ComputationGraph& policy, net::ComputationGraph& target, net::Solver& solver);
 
+		MemoryCache& getMemory() { return *mMemory; }
+		const MemoryCache& getMemory() const { return *mMemory; }
+		
 		std::size_t getSteps() const { return mStepCounter; }
+		std::size_t getLearningSteps() const { return mLearningSteps; }
+		// resets the step counters, e.g. when resuming from a checkpoint.
+		void setSteps( std::size_t steps, std::size_t learning_steps );
 		float getEpsilon() const;
 		
+		// replaces the hyperparameters. The memory size has to stay the same.
+		void setConfig( Config cfg ) { mConfig = std::move(cfg); }
+		
+		// if set, the time spent in learn() is accumulated in timings.
+		void setTimings( StepTimings* timings ) { mTimings = timings; }
+		
 	private:
 		Config mConfig;
 		
@@ -55,8 +69,10 @@ namespace qlearn
 		
 		Vector mErrorCache; // cache vector to prevent reallocation
 		
-		// random engine
-		std::default_random_engine mRandom;
+		StepTimings* mTimings = nullptr;
+		
+		// seeded from the config
+		util::Random mRandom;
 	};
 }
 
@@ -1,6 +1,11 @@
 #include "qlearner.hpp"
 #include "qcore.hpp"
 #include "stats.h"
+#include "memory.hpp"
+#include "net/checkpoint.hpp"
+#include "net/checkpoint_writer.hpp"
+#include "net/solver.hpp"
+#include <stdexcept>
 
 // helpers
 /*Vector concat(const boost::circular_buffer<Vector>& b)
@@ -47,27 +52,130 @@ namespace qlearn
 	
 	int QLearner::learn_step( const Vector& situation, float reward, bool terminal, Solver& solver )
 	{
+		double tau = mConfig.target_tau()( mCore->getLearningSteps() );
+		if( !Config::valid_tau( tau ) )
+			throw std::invalid_argument("target_tau " + std::to_string(tau) + " at learning step " +
+										std::to_string( mCore->getLearningSteps() ) + " is not in [0, 1]");
 		if(mCore->getSteps() % mConfig.update_interval() == 0)
 		{
 			if( mCallback )
 				mCallback(*this, *mStats);
 			
-			// replace network
-			mTargetNet = mNetwork.clone();
-			mTargetGraph = ComputationGraph( mTargetNet );
+			// replace network parameters. The target graph refers to the same layers, so it stays valid.
+			if( tau == 0 )
+			{
+				PhaseTimer timer( mTimings, Phase::TARGET_SYNC );
+				mTargetNet.copy_parameters_from( mNetwork );
+			}
 		}
 		
-		mCore->backward( reward, terminal );
-		auto action = mCore->forward( mNetworkGraph, situation );
-		mStats->record(reward, action.score);
+		{
+			PhaseTimer timer( mTimings, Phase::STORE );
+			mCore->backward( reward, terminal );
+		}
+		
+		Action action;
+		{
+			PhaseTimer timer( mTimings, Phase::ACT );
+			action = mCore->forward( mNetworkGraph, situation );
+		}
+		mStats->record(reward, action.score, terminal);
 		/// \todo technically, this is wrong! reward is shifted by one vs the score!
 		
+		if( mConfig.learning_rate() )
+			solver.getUpdateRule().setRate( mConfig.learning_rate()( mCore->getLearningSteps() ) );
 		float mse = mCore->learn(mNetworkGraph, mTargetGraph, solver);
-		mNetwork.update( solver );
+		{
+			PhaseTimer timer( mTimings, Phase::UPDATE );
+			mNetwork.update( solver );
+		}
+		if( tau > 0 )
+		{
+			PhaseTimer timer( mTimings, Phase::TARGET_SYNC );
+			mTargetNet.blend_parameters_from( mNetwork, tau );
+		}
 		mStats->record_error(mse);
 		return action.id;
 	}
 	
+	Checkpoint QLearner::checkpoint( const Solver& solver ) const
+	{
+		Checkpoint cp( mNetwork, &solver );
+		cp.counter( "steps", mCore->getSteps() ).counter( "learning_steps", mCore->getLearningSteps() );
+		return cp;
+	}
+	
+	void QLearner::save( const std::string& path, const Solver& solver ) const
+	{
+		checkpoint( solver ).write( path );
+	}
+	
+	bool QLearner::save( AsyncCheckpointWriter& writer, const std::string& path, const Solver& solver ) const
+	{
+		return writer.submit( checkpoint( solver ), path );
+	}
+	
+	bool QLearner::save( AsyncCheckpointWriter& writer, const std::string& path, const Solver& solver,
+						 const std::string& memory_path ) const
+	{
+		return writer.submit( {{checkpoint( solver ), path}, {mCore->getMemory(), memory_path}} );
+	}
+	
+	void QLearner::load( const std::string& path, Solver& solver )
+	{
+		MappedCheckpoint checkpoint( path );
+		checkpoint.restore( mNetwork, &solver );
+		mTargetNet.copy_parameters_from( mNetwork );
+		mCore->setSteps( checkpoint.getCounter("steps"), checkpoint.getCounter("learning_steps") );
+	}
+	
+	void QLearner::setConfig( Config cfg )
+	{
+		if( cfg.input_size() != mConfig.input_size() || cfg.action_count() != mConfig.action_count() ||
+			cfg.memory() != mConfig.memory() )
+			throw std::invalid_argument("the problem size and memory of a learner cannot be changed");
+		mCore->setConfig( cfg );
+		mConfig = std::move(cfg);
+	}
+	
+	void QLearner::copy_parameters_from( const QLearner& source, Solver& solver, const Solver& source_solver )
+	{
+		mNetwork.copy_parameters_from( source.mNetwork );
+		mTargetNet.copy_parameters_from( source.mTargetNet );
+		
+		const auto& params = mNetwork.getParameters();
+		const auto& source_params = source.mNetwork.getParameters();
+		// rule to rule, so that a state kept in double is not rounded to number_t
+		for(std::size_t i = 0; i < params.size(); ++i)
+			solver.getUpdateRule().copyState( *params[i], source_solver.getUpdateRule(), *source_params[i] );
+	}
+	
+	std::size_t QLearner::getMemorySize() const
+	{
+		return mCore->getMemory().size();
+	}
+	
+	void QLearner::save_memory( const std::string& path ) const
+	{
+		mCore->getMemory().save( path );
+	}
+	
+	void QLearner::load_memory( const std::string& path )
+	{
+		mCore->getMemory().load( path );
+	}
+	
+	void QLearner::setTimings( StepTimings* timings )
+	{
+		mTimings = timings;
+		mCore->setTimings( timings );
+	}
+	
+	std::size_t QLearner::getLearningSteps() const
+	{
+		return mCore->getLearningSteps();
+	}
+	
 	float QLearner::getCurrentEpsilon() const
 	{
 		return mCore->getEpsilon();
@@ -3,10 +3,18 @@
 
 #include <memory>
 #include <functional>
+#include <string>
 #include "qconfig.hpp"
+#include "timings.hpp"
 #include "net/computation_graph.hpp"
 #include "net/network.hpp"
 
+namespace net
+{
+	class Checkpoint;
+	class AsyncCheckpointWriter;
+}
+
 namespace qlearn
 {
 	class QCore;
@@ -29,10 +37,48 @@ namespace qlearn
 		
 		const net::Network& network() const { return mNetwork; }
 		
+		const Config& config() const { return mConfig; }
+		// replaces the hyperparameters while learning. Input size, action count and memory size have to stay
+		// the same, otherwise this throws std::invalid_argument.
+		void setConfig( Config cfg );
+		
+		// overwrites network, target network and the update rule state in solver with those of source, which
+		// trains with source_solver. Replay memory, statistics and step counters are kept.
+		// Throws std::invalid_argument if the networks are not compatible.
+		void copy_parameters_from( const QLearner& source, net::Solver& solver, const net::Solver& source_solver );
+		
 		void setCallback( qlearn_callback cb ) { mCallback = cb; };
 		
+		// statistics of the training. Their snapshot() can be read from other threads while learning.
+		const Stats& getStats() const { return *mStats; }
+		
 		float getCurrentEpsilon() const;
+		// number of transitions in the replay memory
+		std::size_t getMemorySize() const;
+		std::size_t getLearningSteps() const;
+		
+		// if set, the time spent in the phases of learn_step is accumulated in timings.
+		void setTimings( StepTimings* timings );
+		
+		// writes network, state of the solver's update rule and step counters to a binary checkpoint.
+		void save( const std::string& path, const net::Solver& solver ) const;
+		// snapshots the current state and lets writer save it in the background. Returns false if
+		// the writer is still busy with the previous checkpoint.
+		bool save( net::AsyncCheckpointWriter& writer, const std::string& path, const net::Solver& solver ) const;
+		// as above, but also snapshots the replay memory, which is written to memory_path in the format of
+		// save_memory. The learner can continue while both files are written.
+		bool save( net::AsyncCheckpointWriter& writer, const std::string& path, const net::Solver& solver,
+				   const std::string& memory_path ) const;
+		// restores a checkpoint written by save. The network has to have the same structure.
+		// The target network is reset to the restored network.
+		void load( const std::string& path, net::Solver& solver );
+		
+		// saves / restores the replay memory, see MemoryCache::save and MemoryCache::load.
+		void save_memory( const std::string& path ) const;
+		void load_memory( const std::string& path );
 	private:
+		net::Checkpoint checkpoint( const net::Solver& solver ) const;
+		
 		Config mConfig;
 		std::unique_ptr<QCore> mCore;
 		std::unique_ptr<Stats> mStats;
@@ -45,6 +91,7 @@ namespace qlearn
 		net::ComputationGraph mTargetGraph;
 		
 		qlearn_callback mCallback;
+		StepTimings* mTimings = nullptr;
 	};
 }
 
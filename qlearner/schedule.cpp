@@ -0,0 +1,128 @@
+#include "schedule.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace qlearn
+{
+namespace
+{
+	class Constant final : public ISchedule
+	{
+	public:
+		Constant( double value ) : mValue( value ) { }
+		double value( std::size_t ) const override { return mValue; }
+	private:
+		double mValue;
+	};
+	
+	class Linear final : public ISchedule
+	{
+	public:
+		Linear( double start, double end, std::size_t steps ) : mStart( start ), mEnd( end ), mSteps( steps ) { }
+		double value( std::size_t step ) const override
+		{
+			if( step >= mSteps )
+				return mEnd;
+			double f = (double)step / mSteps;
+			return mEnd * f + mStart * (1 - f);
+		}
+	private:
+		double mStart;
+		double mEnd;
+		std::size_t mSteps;
+	};
+	
+	class Exponential final : public ISchedule
+	{
+	public:
+		Exponential( double start, double decay, double floor ) : mStart( start ), mLogDecay( std::log(decay) ), mFloor( floor ) { }
+		double value( std::size_t step ) const override
+		{
+			return std::max( mFloor, mStart * std::exp( mLogDecay * step ) );
+		}
+	private:
+		double mStart;
+		double mLogDecay;
+		double mFloor;
+	};
+	
+	class Cosine final : public ISchedule
+	{
+	public:
+		Cosine( double start, double end, std::size_t steps ) : mStart( start ), mEnd( end ), mSteps( steps ) { }
+		double value( std::size_t step ) const override
+		{
+			if( step >= mSteps )
+				return mEnd;
+			const double pi = 3.14159265358979323846;
+			double f = 0.5 * (1 + std::cos( pi * step / mSteps ));
+			return mEnd + (mStart - mEnd) * f;
+		}
+	private:
+		double mStart;
+		double mEnd;
+		std::size_t mSteps;
+	};
+	
+	class Piecewise final : public ISchedule
+	{
+	public:
+		Piecewise( std::vector<std::pair<std::size_t, Schedule>> segments ) : mSegments( std::move(segments) ) { }
+		double value( std::size_t step ) const override
+		{
+			// there are only a handful of segments, so a linear scan beats a binary search
+			auto segment = mSegments.rbegin();
+			while( segment->first > step )
+				++segment;
+			return segment->second( step - segment->first );
+		}
+	private:
+		std::vector<std::pair<std::size_t, Schedule>> mSegments;
+	};
+}
+	
+	Schedule::Schedule( double value ) : mSchedule( std::make_shared<Constant>( value ) )
+	{
+	}
+	
+	Schedule::Schedule( std::shared_ptr<const ISchedule> schedule ) : mSchedule( std::move(schedule) )
+	{
+	}
+	
+	Schedule Schedule::constant( double value )
+	{
+		return Schedule( value );
+	}
+	
+	Schedule Schedule::linear( double start, double end, std::size_t steps )
+	{
+		return Schedule( std::make_shared<Linear>( start, end, steps ) );
+	}
+	
+	Schedule Schedule::exponential( double start, double decay, double floor )
+	{
+		if( decay <= 0 )
+			throw std::invalid_argument("exponential schedule needs a positive decay");
+		return Schedule( std::make_shared<Exponential>( start, decay, floor ) );
+	}
+	
+	Schedule Schedule::cosine( double start, double end, std::size_t steps )
+	{
+		return Schedule( std::make_shared<Cosine>( start, end, steps ) );
+	}
+	
+	Schedule Schedule::piecewise( std::vector<std::pair<std::size_t, Schedule>> segments )
+	{
+		if( segments.empty() || segments.front().first != 0 )
+			throw std::invalid_argument("piecewise schedule has to start at step 0");
+		for(std::size_t i = 0; i < segments.size(); ++i)
+		{
+			if( !segments[i].second )
+				throw std::invalid_argument("piecewise schedule contains an empty segment");
+			if( i > 0 && segments[i].first <= segments[i-1].first )
+				throw std::invalid_argument("piecewise schedule segments have to start at increasing steps");
+		}
+		return Schedule( std::make_shared<Piecewise>( std::move(segments) ) );
+	}
+}
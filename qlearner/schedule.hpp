@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace qlearn
+{
+	class ISchedule
+	{
+	public:
+		virtual ~ISchedule() {};
+		virtual double value( std::size_t step ) const = 0;
+	};
+	
+	/*! \class Schedule
+		\brief A hyperparameter that changes with the number of learning steps.
+		\details Schedules are immutable, cheap to copy values that are evaluated in constant time.
+				Constant, linear, exponential and cosine schedules can be chained with piecewise(),
+				e.g. a warmup followed by a cosine decay. A number converts implicitly to a constant
+				schedule, so setters that take a Schedule also accept a plain value.
+				A default constructed schedule is empty, which means that the parameter is not scheduled.
+	*/
+	class Schedule
+	{
+	public:
+		Schedule() = default;
+		Schedule( double value );
+		explicit Schedule( std::shared_ptr<const ISchedule> schedule );
+		
+		static Schedule constant( double value );
+		// goes from start to end in steps steps, then stays at end.
+		static Schedule linear( double start, double end, std::size_t steps );
+		// start * decay^step, but never below floor.
+		static Schedule exponential( double start, double decay, double floor = 0 );
+		// half a cosine period from start to end in steps steps, then stays at end.
+		static Schedule cosine( double start, double end, std::size_t steps );
+		// each segment starts at the given step and is evaluated relative to that step. Starts have to
+		// be increasing, and the first has to be 0.
+		static Schedule piecewise( std::vector<std::pair<std::size_t, Schedule>> segments );
+		
+		double operator()( std::size_t step ) const { return mSchedule->value( step ); }
+		
+		explicit operator bool() const { return (bool)mSchedule; }
+	private:
+		std::shared_ptr<const ISchedule> mSchedule;
+	};
+}
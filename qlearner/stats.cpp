@@ -1,37 +1,236 @@
 #include "stats.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
 
 namespace qlearn
 {
-	Stats::Stats(std::size_t window_size) : 
-		mSmoothedReward( tag::rolling_window::window_size = 10000 ),
-		mSmoothedQVal( tag::rolling_window::window_size = 10000 ),
-		mSmoothedMSE( tag::rolling_window::window_size = 10000 )
+	constexpr double QuantileSketch::RELATIVE_ACCURACY;
+	constexpr double QuantileSketch::MIN_MAGNITUDE;
+	constexpr double QuantileSketch::MAX_MAGNITUDE;
+	constexpr double StatsSnapshot::QUANTILES[3];
+
+	RollingWindow::RollingWindow( std::size_t size ) : mValues( size )
+	{
+		assert( size > 0 );
+	}
+
+	void RollingWindow::push( float value )
+	{
+		if( mCount == mValues.size() )
+		{
+			float old = mValues[mNext];
+			mSum -= old;
+			mSumSquares -= double(old) * old;
+		} else
+		{
+			++mCount;
+		}
+		mValues[mNext] = value;
+		mSum += value;
+		mSumSquares += double(value) * value;
+		mRoundSum += value;
+		mRoundSquares += double(value) * value;
+
+		if( ++mNext == mValues.size() )
+		{
+			mNext = 0;
+			// the window now holds exactly the values of this round, whose sums have no subtractions
+			mSum = mRoundSum;
+			mSumSquares = mRoundSquares;
+			mRoundSum = 0;
+			mRoundSquares = 0;
+		}
+	}
+
+	float RollingWindow::mean() const
+	{
+		return mCount ? mSum / mCount : 0;
+	}
+
+	float RollingWindow::variance() const
+	{
+		if( mCount == 0 )
+			return 0;
+		double m = mSum / mCount;
+		return std::max( 0.0, mSumSquares / mCount - m * m );
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	QuantileSketch::QuantileSketch() :
+		mLogGamma( std::log( (1 + RELATIVE_ACCURACY) / (1 - RELATIVE_ACCURACY) ) )
+	{
+		std::size_t buckets = std::ceil( std::log( MAX_MAGNITUDE / MIN_MAGNITUDE ) / mLogGamma ) + 1;
+		mPositive.resize( buckets, 0 );
+		mNegative.resize( buckets, 0 );
+	}
+
+	int QuantileSketch::bucket( double magnitude ) const
+	{
+		int b = std::ceil( std::log( magnitude / MIN_MAGNITUDE ) / mLogGamma );
+		return std::min( std::max( b, 0 ), int(mPositive.size()) - 1 );
+	}
+
+	double QuantileSketch::value( int bucket ) const
+	{
+		// bucket b covers (MIN * gamma^(b-1), MIN * gamma^b]; this estimate is within the relative accuracy of both ends
+		double gamma = std::exp( mLogGamma );
+		return MIN_MAGNITUDE * std::exp( bucket * mLogGamma ) * 2 / (1 + gamma);
+	}
+
+	void QuantileSketch::add( float value )
+	{
+		if( std::isnan( value ) )
+			return;
+		++mCount;
+		double magnitude = std::abs( value );
+		if( magnitude < MIN_MAGNITUDE )
+			++mZero;
+		else if( value > 0 )
+			++mPositive[bucket( magnitude )];
+		else
+			++mNegative[bucket( magnitude )];
+	}
+
+	void QuantileSketch::reset()
+	{
+		std::fill( mPositive.begin(), mPositive.end(), 0 );
+		std::fill( mNegative.begin(), mNegative.end(), 0 );
+		mZero = 0;
+		mCount = 0;
+	}
+
+	float QuantileSketch::quantile( double q ) const
+	{
+		if( mCount == 0 )
+			return 0;
+		std::uint64_t rank = std::min( std::uint64_t(q * (mCount - 1)), mCount - 1 );
+
+		// walk the buckets in ascending order of their values
+		std::uint64_t seen = 0;
+		for(int b = mNegative.size() - 1; b >= 0; --b)
+		{
+			seen += mNegative[b];
+			if( seen > rank )
+				return -value( b );
+		}
+		seen += mZero;
+		if( seen > rank )
+			return 0;
+		for(std::size_t b = 0; b < mPositive.size(); ++b)
+		{
+			seen += mPositive[b];
+			if( seen > rank )
+				return value( b );
+		}
+		return value( mPositive.size() - 1 );
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	Stats::Stats( std::size_t window_size, std::size_t episode_window, std::size_t publish_interval ) :
+		mReward( window_size ), mQVal( window_size ), mError( window_size ), mReturns( episode_window ),
+		mPublishInterval( publish_interval )
 	{
-		
+		static_assert( std::is_trivially_copyable<StatsSnapshot>::value, "snapshots are copied as raw words" );
+		for(auto& word : mPublished)
+			word.store( 0, std::memory_order_relaxed );
+		publish();
 	}
-		
+
 	float Stats::getSmoothReward() const
 	{
-		return rolling_mean(mSmoothedReward);
+		return mReward.mean();
 	}
 	float Stats::getSmoothQVal() const
 	{
-		return rolling_mean(mSmoothedQVal);
+		return mQVal.mean();
 	}
 	float Stats::getSmoothMSE() const
 	{
-		return rolling_mean(mSmoothedMSE);
+		return mError.mean();
 	}
 
-	void Stats::record( float reward, float qval )
+	void Stats::record( float reward, float qval, bool terminal )
 	{
-		mSmoothedReward(reward);
-		mSmoothedQVal(qval);
+		mReward.push( reward );
+		mQVal.push( qval );
+		mRewardSketch.add( reward );
+
+		mEpisodeReturn += reward;
+		if( terminal )
+		{
+			mLastReturn = mEpisodeReturn;
+			mReturns.push( mEpisodeReturn );
+			mEpisodeReturn = 0;
+			++mEpisodes;
+		}
+
+		if( ++mSteps % mPublishInterval == 0 )
+			publish();
 	}
-	
+
 	void Stats::record_error( float error )
 	{
-		mSmoothedMSE(error);
+		mError.push( error );
+		mErrorSketch.add( error );
+	}
+
+	StatsSnapshot Stats::current() const
+	{
+		StatsSnapshot s;
+		s.steps = mSteps;
+		s.episodes = mEpisodes;
+		s.reward_mean = mReward.mean();
+		s.reward_variance = mReward.variance();
+		s.qval_mean = mQVal.mean();
+		s.qval_variance = mQVal.variance();
+		s.error_mean = mError.mean();
+		s.error_variance = mError.variance();
+		s.last_return = mLastReturn;
+		s.return_mean = mReturns.mean();
+		for(int i = 0; i < 3; ++i)
+		{
+			s.reward_quantiles[i] = mRewardSketch.quantile( StatsSnapshot::QUANTILES[i] );
+			s.error_quantiles[i] = mErrorSketch.quantile( StatsSnapshot::QUANTILES[i] );
+		}
+		return s;
+	}
+
+	void Stats::publish()
+	{
+		std::uint64_t words[SNAPSHOT_WORDS] = {};
+		StatsSnapshot s = current();
+		std::memcpy( words, &s, sizeof(s) );
+		mRewardSketch.reset();
+		mErrorSketch.reset();
+
+		// an odd sequence number marks a write in progress
+		std::uint64_t sequence = mSequence.load( std::memory_order_relaxed );
+		mSequence.store( sequence + 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+		for(std::size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+			mPublished[i].store( words[i], std::memory_order_relaxed );
+		mSequence.store( sequence + 2, std::memory_order_release );
 	}
-}
 
+	StatsSnapshot Stats::snapshot() const
+	{
+		std::uint64_t words[SNAPSHOT_WORDS];
+		while( true )
+		{
+			std::uint64_t before = mSequence.load( std::memory_order_acquire );
+			if( before % 2 == 1 )
+				continue;
+			for(std::size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+				words[i] = mPublished[i].load( std::memory_order_relaxed );
+			std::atomic_thread_fence( std::memory_order_acquire );
+			if( mSequence.load( std::memory_order_relaxed ) == before )
+				break;
+		}
+		StatsSnapshot s;
+		std::memcpy( &s, words, sizeof(s) );
+		return s;
+	}
+}
@@ -1,28 +1,147 @@
 #pragma once
 
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/rolling_mean.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 namespace qlearn
 {
-	using namespace boost::accumulators;
-	
+	/*! \class RollingWindow
+		\brief Mean and variance of the last values, updated in O(1) per value.
+		\details Keeps running sums of the values in the window. To avoid that rounding errors pile up,
+				the values pushed since the window last wrapped are summed separately as well. Once the
+				window has been overwritten completely, these sums contain exactly the window's values
+				and replace the running sums, so errors never persist for more than one round.
+	*/
+	class RollingWindow
+	{
+	public:
+		explicit RollingWindow( std::size_t size );
+
+		void push( float value );
+
+		std::size_t size() const { return mCount; }
+		float mean() const;
+		float variance() const;
+
+	private:
+		std::vector<float> mValues;
+		std::size_t mNext = 0;
+		std::size_t mCount = 0;
+		double mSum = 0;
+		double mSumSquares = 0;
+		// sums of the values pushed in the current round
+		double mRoundSum = 0;
+		double mRoundSquares = 0;
+	};
+
+	/*! \class QuantileSketch
+		\brief Approximate quantiles with a fixed number of logarithmic buckets.
+		\details Each bucket covers values whose magnitude differs by at most a factor of
+				(1 + RELATIVE_ACCURACY) / (1 - RELATIVE_ACCURACY), so a quantile is returned with a relative
+				error of at most RELATIVE_ACCURACY. Magnitudes below MIN_MAGNITUDE count as zero, larger
+				ones than MAX_MAGNITUDE are clamped. Adding a value does not allocate.
+	*/
+	class QuantileSketch
+	{
+	public:
+		static constexpr double RELATIVE_ACCURACY = 0.01;
+		static constexpr double MIN_MAGNITUDE = 1e-6;
+		static constexpr double MAX_MAGNITUDE = 1e6;
+
+		QuantileSketch();
+
+		// NaNs are ignored
+		void add( float value );
+		void reset();
+
+		std::uint64_t count() const { return mCount; }
+		// approximate q-quantile, q in [0, 1]. Returns 0 if the sketch is empty.
+		float quantile( double q ) const;
+
+	private:
+		int bucket( double magnitude ) const;
+		double value( int bucket ) const;
+
+		double mLogGamma;
+		std::vector<std::uint64_t> mPositive;
+		std::vector<std::uint64_t> mNegative;
+		std::uint64_t mZero = 0;
+		std::uint64_t mCount = 0;
+	};
+
+	// statistics of a learner at one point in time
+	struct StatsSnapshot
+	{
+		std::uint64_t steps = 0;
+		std::uint64_t episodes = 0;
+
+		// over the last window_size steps
+		float reward_mean = 0;
+		float reward_variance = 0;
+		float qval_mean = 0;
+		float qval_variance = 0;
+		float error_mean = 0;
+		float error_variance = 0;
+
+		// summed rewards of the last finished episode, and mean over the last episode_window episodes
+		float last_return = 0;
+		float return_mean = 0;
+
+		// p50, p90 and p99 of the steps since the previous snapshot was published
+		static constexpr double QUANTILES[3] = {0.5, 0.9, 0.99};
+		float reward_quantiles[3] = {};
+		float error_quantiles[3] = {};
+	};
+
+	/*! \class Stats
+		\brief Training statistics of a QLearner.
+		\details Recording is done by the learner thread only, and costs O(1) per step.
+				Every publish_interval steps, the current values are published as a StatsSnapshot,
+				which any thread can read with snapshot() without blocking the learner. The snapshot
+				is protected by a sequence lock: the writer never waits, and readers retry if the
+				snapshot changed while they copied it.
+	*/
 	class Stats
 	{
 	public:
-		Stats(std::size_t window_size);
-		
+		Stats( std::size_t window_size, std::size_t episode_window = 100, std::size_t publish_interval = 1000 );
+
+		// smoothed values, only to be used from the learner thread
 		float getSmoothReward() const;
 		float getSmoothQVal() const;
 		float getSmoothMSE() const;
-		
-		void record( float reward, float qval );
+
+		// records the reward of the last step and the Q-value of the chosen action.
+		// if terminal is set, the last step finished an episode.
+		void record( float reward, float qval, bool terminal = false );
 		void record_error( float error );
+
+		// publishes the current statistics immediately
+		void publish();
+		// latest published statistics. Can be called from any thread.
+		StatsSnapshot snapshot() const;
+
 	private:
-		// stats smoothed over last steps
-		accumulator_set<float, stats<tag::rolling_mean> > mSmoothedReward;
-		accumulator_set<float, stats<tag::rolling_mean> > mSmoothedQVal;
-		accumulator_set<float, stats<tag::rolling_mean> > mSmoothedMSE;
+		StatsSnapshot current() const;
+
+		RollingWindow mReward;
+		RollingWindow mQVal;
+		RollingWindow mError;
+		RollingWindow mReturns;
+		QuantileSketch mRewardSketch;
+		QuantileSketch mErrorSketch;
+
+		std::uint64_t mSteps = 0;
+		std::uint64_t mEpisodes = 0;
+		float mEpisodeReturn = 0;
+		float mLastReturn = 0;
+		std::size_t mPublishInterval;
+
+		// the published snapshot, copied word by word
+		static const std::size_t SNAPSHOT_WORDS = (sizeof(StatsSnapshot) + 7) / 8;
+		std::atomic<std::uint64_t> mSequence{0};
+		std::array<std::atomic<std::uint64_t>, SNAPSHOT_WORDS> mPublished;
 	};
 }
@@ -0,0 +1,260 @@
+#include "sweep.hpp"
+#include "game_loop.hpp"
+#include "qlearner.hpp"
+#include "stats.h"
+#include "net/network.hpp"
+#include "net/solver.hpp"
+#include "games/game.h"
+#include "util/affinity.hpp"
+#include "util/random.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+namespace qlearn
+{
+namespace
+{
+	std::string format_value( double value )
+	{
+		char buffer[32];
+		std::snprintf( buffer, sizeof(buffer), "%.9g", value );
+		return buffer;
+	}
+	
+	std::string csv_quote( const std::string& text )
+	{
+		std::string quoted = "\"";
+		for(char c : text)
+		{
+			if( c == '"' )
+				quoted += '"';
+			quoted += c;
+		}
+		return quoted + "\"";
+	}
+	
+	// quotes text only if it would otherwise break the CSV row, so that numbers stay plain
+	std::string csv_field( const std::string& text )
+	{
+		return text.find_first_of( ",\"\r\n" ) == std::string::npos ? text : csv_quote( text );
+	}
+}
+	
+	SearchSpace& SearchSpace::choice( const std::string& path, std::vector<std::string> values )
+	{
+		if( values.empty() )
+			throw std::invalid_argument("parameter " + path + " has no values");
+		Parameter parameter;
+		parameter.path = path;
+		parameter.values = std::move(values);
+		mParameters.push_back( std::move(parameter) );
+		return *this;
+	}
+	
+	SearchSpace& SearchSpace::choice( const std::string& path, const std::vector<double>& values )
+	{
+		std::vector<std::string> formatted;
+		for(double value : values)
+			formatted.push_back( format_value( value ) );
+		return choice( path, std::move(formatted) );
+	}
+	
+	SearchSpace& SearchSpace::uniform( const std::string& path, double low, double high, bool integer )
+	{
+		if( !(low <= high) )
+			throw std::invalid_argument("parameter " + path + " has an empty range");
+		Parameter parameter;
+		parameter.path = path;
+		parameter.low = low;
+		parameter.high = high;
+		parameter.integer = integer;
+		mParameters.push_back( std::move(parameter) );
+		return *this;
+	}
+	
+	SearchSpace& SearchSpace::log_uniform( const std::string& path, double low, double high )
+	{
+		if( !(low > 0) )
+			throw std::invalid_argument("parameter " + path + " needs a positive range");
+		uniform( path, low, high );
+		mParameters.back().log_scale = true;
+		return *this;
+	}
+	
+	std::vector<Trial> SearchSpace::grid() const
+	{
+		std::size_t count = 1;
+		for(const auto& parameter : mParameters)
+		{
+			if( parameter.values.empty() )
+				throw std::logic_error("parameter " + parameter.path + " is a range and cannot be used in a grid");
+			count *= parameter.values.size();
+		}
+		
+		std::vector<Trial> trials( count );
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			trials[i].id = i;
+			// the last parameter changes fastest
+			std::size_t rest = i;
+			for(auto parameter = mParameters.rbegin(); parameter != mParameters.rend(); ++parameter)
+			{
+				trials[i].values.emplace_back( parameter->path, parameter->values[rest % parameter->values.size()] );
+				rest /= parameter->values.size();
+			}
+			std::reverse( trials[i].values.begin(), trials[i].values.end() );
+		}
+		return trials;
+	}
+	
+	std::vector<Trial> SearchSpace::sample( std::size_t count, std::uint64_t seed ) const
+	{
+		util::Random random( seed );
+		std::vector<Trial> trials( count );
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			trials[i].id = i;
+			for(const auto& parameter : mParameters)
+			{
+				std::string value;
+				if( !parameter.values.empty() )
+				{
+					value = parameter.values[random.uniform_int( parameter.values.size() )];
+				} else
+				{
+					double u = random.uniform();
+					double x = parameter.log_scale ?
+						std::exp( std::log( parameter.low ) + u * (std::log( parameter.high ) - std::log( parameter.low )) ) :
+						parameter.low + u * (parameter.high - parameter.low);
+					value = format_value( parameter.integer ? std::round( x ) : x );
+				}
+				trials[i].values.emplace_back( parameter.path, value );
+			}
+		}
+		return trials;
+	}
+	
+	std::vector<std::string> SearchSpace::getPaths() const
+	{
+		std::vector<std::string> paths;
+		for(const auto& parameter : mParameters)
+			paths.push_back( parameter.path );
+		return paths;
+	}
+	
+	// ---------------------------------------------------------------------------------------------
+	struct SweepRunner::Rungs
+	{
+		std::mutex mutex;
+		// the rewards of all trials at each evaluation
+		std::vector<std::vector<double>> rewards;
+	};
+	
+	SweepRunner::SweepRunner( Experiment base, game_factory_t factory, SweepOptions options ) :
+		mBase( std::move(base) ), mFactory( std::move(factory) ), mOptions( std::move(options) ),
+		mRungs( std::make_unique<Rungs>() )
+	{
+		if( mOptions.eval_interval == 0 )
+			throw std::invalid_argument("sweep evaluation interval has to be positive");
+	}
+	
+	SweepRunner::~SweepRunner() = default;
+	
+	std::vector<TrialResult> SweepRunner::run( const std::vector<Trial>& trials )
+	{
+		mRungs->rewards.clear();
+		std::vector<TrialResult> results( trials.size() );
+		
+		std::size_t workers = mOptions.workers > 0 ? mOptions.workers : mBase.threads().threads;
+		auto groups = util::split_cores( mOptions.cores.empty() ? mBase.threads().cores : mOptions.cores,
+										 mOptions.cores_per_trial );
+		run_pinned( trials.size(), workers, groups, [&]( std::size_t i ) { results[i] = runTrial( trials[i] ); } );
+		return results;
+	}
+	
+	TrialResult SweepRunner::runTrial( const Trial& trial )
+	{
+		TrialResult result;
+		result.trial = trial;
+		auto start = std::chrono::steady_clock::now();
+		try
+		{
+			Experiment experiment = mBase.with( trial.values );
+			const Config& config = experiment.config();
+			auto game = mFactory( experiment, config.seed() );
+			QLearner learner( config, experiment.makeNetwork( config.seed() ) );
+			auto solver = experiment.makeSolver();
+			GameLoop loop( *game, learner, *solver );
+			
+			result.best_reward = -INFINITY;
+			while( result.steps < mOptions.steps )
+			{
+				loop.step();
+				if( ++result.steps % mOptions.eval_interval == 0 )
+				{
+					double smooth = learner.getStats().getSmoothReward();
+					result.best_reward = std::max( result.best_reward, smooth );
+					if( result.steps < mOptions.steps && report( result.steps / mOptions.eval_interval - 1, smooth ) )
+					{
+						result.stopped = true;
+						break;
+					}
+				}
+			}
+			result.reward = learner.getStats().getSmoothReward();
+			result.best_reward = std::max( result.best_reward, result.reward );
+		} catch( std::exception& e )
+		{
+			result.error = e.what();
+		}
+		result.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+		return result;
+	}
+	
+	bool SweepRunner::report( std::size_t evaluation, double reward )
+	{
+		std::lock_guard<std::mutex> lock( mRungs->mutex );
+		auto& rewards = mRungs->rewards;
+		if( rewards.size() <= evaluation )
+			rewards.resize( evaluation + 1 );
+		auto& rung = rewards[evaluation];
+		rung.push_back( reward );
+		if( mOptions.stop_quantile <= 0 || rung.size() < std::max<std::size_t>( mOptions.min_trials, 1 ) )
+			return false;
+		
+		std::vector<double> sorted = rung;
+		auto threshold = sorted.begin() + (std::size_t)(mOptions.stop_quantile * (sorted.size() - 1));
+		std::nth_element( sorted.begin(), threshold, sorted.end() );
+		return reward < *threshold;
+	}
+	
+	void SweepRunner::writeTable( std::ostream& out, const std::vector<std::string>& paths, const std::vector<TrialResult>& results )
+	{
+		out << "trial";
+		for(const auto& path : paths)
+			out << "," << csv_field( path );
+		out << ",steps,reward,best_reward,status,seconds,error\n";
+		
+		for(const auto& result : results)
+		{
+			out << result.trial.id;
+			for(const auto& path : paths)
+			{
+				out << ",";
+				for(const auto& value : result.trial.values)
+				{
+					if( value.first == path )
+						out << csv_field( value.second );
+				}
+			}
+			const char* status = !result.error.empty() ? "error" : (result.stopped ? "stopped" : "completed");
+			out << "," << result.steps << "," << format_value( result.reward ) << "," << format_value( result.best_reward )
+				<< "," << status << "," << format_value( result.seconds ) << "," << csv_quote( result.error ) << "\n";
+		}
+	}
+}
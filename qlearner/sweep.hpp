@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "experiment.hpp"
+
+namespace qlearn
+{
+	// one point of a search space: values for entries of the experiment description, see Experiment::with.
+	struct Trial
+	{
+		std::size_t id = 0;
+		std::vector<Experiment::override_t> values;
+	};
+	
+	/*! \class SearchSpace
+		\brief Hyperparameters to search over, addressed by their path in the experiment description.
+		\details Parameters either take one of a list of values, or are drawn from a range. grid() enumerates
+				all combinations of the listed values, sample() draws random trials from all parameters.
+	*/
+	class SearchSpace
+	{
+	public:
+		SearchSpace& choice( const std::string& path, std::vector<std::string> values );
+		SearchSpace& choice( const std::string& path, const std::vector<double>& values );
+		// uniform in [low, high]. Integer parameters are rounded.
+		SearchSpace& uniform( const std::string& path, double low, double high, bool integer = false );
+		// uniform in the logarithm, e.g. for learning rates
+		SearchSpace& log_uniform( const std::string& path, double low, double high );
+		
+		// all combinations of the choices. Throws std::logic_error if there are ranges.
+		std::vector<Trial> grid() const;
+		std::vector<Trial> sample( std::size_t count, std::uint64_t seed ) const;
+		
+		// paths of all parameters
+		std::vector<std::string> getPaths() const;
+		
+	private:
+		struct Parameter
+		{
+			std::string path;
+			std::vector<std::string> values;
+			double low = 0;
+			double high = 0;
+			bool log_scale = false;
+			bool integer = false;
+		};
+		std::vector<Parameter> mParameters;
+	};
+	
+	struct SweepOptions
+	{
+		std::size_t steps = 100000;			// environment steps per trial
+		std::size_t eval_interval = 10000;	// steps between early stopping decisions
+		// a trial is stopped if its reward is below this quantile of the rewards that the trials so far had
+		// after the same number of steps. 0 disables early stopping.
+		double stop_quantile = 0.5;
+		std::size_t min_trials = 4;			// number of results needed for a decision
+		std::size_t workers = 0;			// concurrent trials, 0 uses the thread count of the experiment
+		std::vector<int> cores;				// cores to run on, empty uses the experiment's cores or all
+		std::size_t cores_per_trial = 1;
+	};
+	
+	struct TrialResult
+	{
+		Trial trial;
+		std::size_t steps = 0;
+		double reward = 0;			// smoothed reward at the end of the trial
+		double best_reward = 0;		// best smoothed reward at an evaluation
+		bool stopped = false;		// stopped early
+		double seconds = 0;
+		std::string error;			// set if the trial could not run, e.g. because of an invalid value
+	};
+	
+	/*! \class SweepRunner
+		\brief Trains headless QLearners for many trials concurrently.
+		\details Each worker thread is pinned to its own group of cores and runs one trial after the other.
+				Every eval_interval steps the smoothed reward of a trial is compared with that of all trials
+				that reached the same step before (median stopping), and trials that fall behind are
+				stopped early to leave the cores to more promising ones.
+	*/
+	class SweepRunner
+	{
+	public:
+		SweepRunner( Experiment base, game_factory_t factory, SweepOptions options );
+		~SweepRunner();
+		
+		// runs all trials and returns their results, in the order of trials.
+		std::vector<TrialResult> run( const std::vector<Trial>& trials );
+		
+		// writes results as CSV, one row per trial with one column per parameter path.
+		static void writeTable( std::ostream& out, const std::vector<std::string>& paths, const std::vector<TrialResult>& results );
+		
+	private:
+		TrialResult runTrial( const Trial& trial );
+		// records reward for the evaluation after step steps and returns whether the trial should stop
+		bool report( std::size_t evaluation, double reward );
+		
+		struct Rungs;
+		
+		Experiment mBase;
+		game_factory_t mFactory;
+		SweepOptions mOptions;
+		std::unique_ptr<Rungs> mRungs;
+	};
+}
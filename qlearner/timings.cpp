@@ -0,0 +1,19 @@
+#include "timings.hpp"
+
+namespace qlearn
+{
+	const char* getPhaseName( Phase phase )
+	{
+		switch( phase )
+		{
+		case Phase::ACT:			return "act";
+		case Phase::STORE:			return "store";
+		case Phase::SAMPLE:			return "sample";
+		case Phase::FORWARD:		return "forward";
+		case Phase::BACKWARD:		return "backward";
+		case Phase::UPDATE:			return "update";
+		case Phase::TARGET_SYNC:	return "target sync";
+		default:					return "unknown";
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace qlearn
+{
+	enum class Phase
+	{
+		ACT,			// choosing the next action
+		STORE,			// storing the last transition in the replay memory
+		SAMPLE,			// drawing transitions from the replay memory
+		FORWARD,		// evaluating policy and target networks during learning
+		BACKWARD,		// backpropagation of the TD errors
+		UPDATE,			// applying the gradients
+		TARGET_SYNC,	// updating the target network
+		COUNT
+	};
+	
+	const char* getPhaseName( Phase phase );
+	
+	/*! \class StepTimings
+		\brief Accumulates the time spent in the different phases of QLearner::learn_step.
+		\details Timing is only done if a StepTimings object is set with QLearner::setTimings,
+				otherwise the phase timers reduce to a null check.
+				If an allocation counter is set (e.g. util::allocation_count), the number of heap
+				allocations made in each phase is recorded as well.
+	*/
+	struct StepTimings
+	{
+		using duration = std::chrono::nanoseconds;
+		using counter_t = std::size_t(*)();
+		
+		std::array<duration, (std::size_t)Phase::COUNT> total{};
+		std::array<std::size_t, (std::size_t)Phase::COUNT> allocations{};
+		counter_t allocation_counter = nullptr;
+		
+		duration& operator[]( Phase phase ) { return total[(std::size_t)phase]; }
+		duration operator[]( Phase phase ) const { return total[(std::size_t)phase]; }
+		
+		void reset()
+		{
+			total.fill( duration::zero() );
+			allocations.fill( 0 );
+		}
+	};
+	
+	// adds the time between construction and destruction to the given phase, if timings is not null.
+	class PhaseTimer
+	{
+		using clock = std::chrono::steady_clock;
+	public:
+		PhaseTimer( StepTimings* timings, Phase phase ) : mTimings( timings ), mPhase( phase )
+		{
+			if( mTimings )
+			{
+				if( mTimings->allocation_counter )
+					mAllocations = mTimings->allocation_counter();
+				mStart = clock::now();
+			}
+		}
+		
+		~PhaseTimer()
+		{
+			if( mTimings )
+			{
+				(*mTimings)[mPhase] += std::chrono::duration_cast<StepTimings::duration>( clock::now() - mStart );
+				if( mTimings->allocation_counter )
+					mTimings->allocations[(std::size_t)mPhase] += mTimings->allocation_counter() - mAllocations;
+			}
+		}
+		
+		PhaseTimer( const PhaseTimer& ) = delete;
+		PhaseTimer& operator=( const PhaseTimer& ) = delete;
+	private:
+		StepTimings* mTimings;
+		Phase mPhase;
+		clock::time_point mStart;
+		std::size_t mAllocations = 0;
+	};
+}
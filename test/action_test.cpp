@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "qlearner/action.h"
+#include "qlearner/qcore.hpp"
+#include "net/network.hpp"
+#include "net/computation_graph.hpp"
+#include "net/fc_layer.hpp"
+#include "net/tanh_layer.hpp"
+
+using namespace net;
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(action)
+
+BOOST_AUTO_TEST_CASE(best_actions)
+{
+	Matrix q(4, 3);
+	q << 1, 2, 3,
+		 5, 4, 3,
+		 0, 7, 7,
+		 -1, -1, -2;
+	Eigen::VectorXi index( 4 );
+	Vector best( 4 );
+	Action actions[4];
+	getBestActions( q, index, best, actions );
+	const std::size_t expected[] = {2, 0, 1, 0};
+	for(int i = 0; i < 4; ++i)
+	{
+		BOOST_CHECK_EQUAL( actions[i].id, expected[i] );
+		BOOST_CHECK_EQUAL( actions[i].score, q.row(i).maxCoeff() );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(epsilon_greedy)
+{
+	const int INPUTS = 6, ACTIONS = 4, BATCH = 500;
+	Network network;
+	network << FcLayer(Matrix::Random(ACTIONS, INPUTS)) << TanhLayer(Matrix::Random(ACTIONS, 1));
+	ComputationGraph graph( network );
+	Matrix states = Matrix::Random( INPUTS, BATCH );
+
+	EpsilonGreedy policy( ACTIONS, util::Random( 1 ) );
+
+	// without exploration, all actions are greedy
+	const auto& greedy = policy.select( graph, states, 0.f );
+	BOOST_REQUIRE_EQUAL( greedy.size(), (std::size_t)BATCH );
+	BOOST_CHECK_EQUAL( policy.getGreedyCount(), (std::size_t)BATCH );
+	for(int i = 0; i < BATCH; ++i)
+	{
+		Action expected = getAction( graph, states.col(i) );
+		BOOST_REQUIRE_EQUAL( greedy[i].id, expected.id );
+		BOOST_REQUIRE_EQUAL( greedy[i].score, expected.score );
+	}
+
+	// with full exploration, the network is not needed
+	std::vector<int> counts( ACTIONS, 0 );
+	for(const auto& action : policy.select( graph, states, 1.f ))
+	{
+		BOOST_REQUIRE( action.id < (std::size_t)ACTIONS );
+		BOOST_REQUIRE_EQUAL( action.score, 0.f );
+		++counts[action.id];
+	}
+	BOOST_CHECK_EQUAL( policy.getGreedyCount(), 0u );
+	for(int c : counts)
+		BOOST_CHECK( c > BATCH / ACTIONS / 2 );
+
+	// mixed: the greedy states get the greedy action
+	policy.select( graph, states, 0.5f );
+	BOOST_CHECK( policy.getGreedyCount() > BATCH / 3 && policy.getGreedyCount() < 2 * BATCH / 3 );
+	std::size_t matching = 0;
+	for(int i = 0; i < BATCH; ++i)
+		matching += policy.getActions()[i].id == getAction( graph, states.col(i) ).id;
+	BOOST_CHECK( matching >= policy.getGreedyCount() );
+}
+
+// QCore::forward explores with probability epsilon, and is greedy when it does not learn. (It used to
+// explore with probability 1 - epsilon, and always when not learning.)
+BOOST_AUTO_TEST_CASE(qcore_exploration)
+{
+	const int INPUTS = 6, ACTIONS = 4, STEPS = 200;
+	Network network;
+	network << FcLayer(Matrix::Random(ACTIONS, INPUTS)) << TanhLayer(Matrix::Random(ACTIONS, 1));
+	ComputationGraph graph( network );
+	std::vector<Vector> states;
+	for(int i = 0; i < STEPS; ++i)
+		states.push_back( Vector::Random( INPUTS ) );
+
+	QCore greedy( Config( INPUTS, ACTIONS, 100 ).epsilon( 0.0 ) );
+	QCore exploring( Config( INPUTS, ACTIONS, 100 ).epsilon( 1.0 ) );
+	for(const auto& state : states)
+	{
+		Action expected = getAction( graph, state );
+		Action action = greedy.forward( graph, state, true );
+		BOOST_REQUIRE_EQUAL( action.id, expected.id );
+		BOOST_REQUIRE_EQUAL( action.score, expected.score );
+		action = exploring.forward( graph, state, false );
+		BOOST_REQUIRE_EQUAL( action.id, expected.id );
+		BOOST_REQUIRE_EQUAL( action.score, expected.score );
+	}
+
+	// with full exploration, the network is never evaluated, so its output stays that of the probe
+	Vector probe = Vector::Random( INPUTS );
+	Vector expected = graph.forward( probe );
+	std::vector<int> counts( ACTIONS, 0 );
+	for(const auto& state : states)
+	{
+		Action action = exploring.forward( graph, state, true );
+		BOOST_REQUIRE( action.id < (std::size_t)ACTIONS );
+		BOOST_REQUIRE_EQUAL( action.score, 0.f );
+		++counts[action.id];
+	}
+	BOOST_CHECK( graph.output() == expected );
+	for(int c : counts)
+		BOOST_CHECK( c > 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "util/alloc_count.hpp"
+#include "qlearner/qlearner.hpp"
+#include "qlearner/action.h"
+#include "qlearner/timings.hpp"
+#include "net/network.hpp"
+#include "net/computation_graph.hpp"
+#include "net/fc_layer.hpp"
+#include "net/relu_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/dueling_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+
+using namespace net;
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(allocations)
+
+// runs learn_step until the replay memory is full, and then checks that further steps do not
+// touch the heap.
+void check_steady_state( Network network, Schedule tau, Schedule rate = Schedule(),
+						 std::unique_ptr<IUpdateRule> rule = std::make_unique<RMSProp>(0.9, 0.001, 0.01) )
+{
+	const std::size_t STATE_SIZE = 8;
+	const std::size_t MEMORY = 200;
+	QLearner learner( Config( STATE_SIZE, 3, MEMORY ).batch_size(16)
+													 .init_memory_size(50)
+													 .update_interval(1000000)
+													 .target_tau(tau)
+													 .learning_rate(rate), std::move(network) );
+	Solver solver( std::move(rule) );
+
+	std::vector<Vector> states;
+	for(int i = 0; i < 16; ++i)
+		states.push_back( Vector::Random(STATE_SIZE) );
+
+	std::size_t step = 0;
+	auto run = [&]( std::size_t count )
+	{
+		for(std::size_t i = 0; i < count; ++i, ++step)
+			learner.learn_step( states[step % states.size()], (step % 7) * 0.1f, step % 13 == 0, solver );
+	};
+	run( 2 * MEMORY );
+
+	StepTimings timings;
+	timings.allocation_counter = util::allocation_count;
+	learner.setTimings( &timings );
+
+	util::AllocationScope allocations;
+	run( 100 );
+	std::size_t total = allocations.count();
+	learner.setTimings( nullptr );
+
+	for(std::size_t p = 0; p < (std::size_t)Phase::COUNT; ++p)
+	{
+		BOOST_CHECK_MESSAGE( timings.allocations[p] == 0, getPhaseName((Phase)p) << ": " << timings.allocations[p] << " allocations in 100 steps" );
+	}
+	BOOST_CHECK_EQUAL( total, 0u );
+}
+
+BOOST_AUTO_TEST_CASE(learn_step)
+{
+	Network network;
+	network << FcLayer(Matrix::Random(16, 8)) << ReLULayer(Matrix::Random(16, 1));
+	network << FcLayer(Matrix::Random(3, 16)) << TanhLayer(Matrix::Random(3, 1));
+	check_steady_state( std::move(network), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(learn_step_dueling_soft_update)
+{
+	Network value;
+	value << FcLayer(Matrix::Random(1, 16));
+	Network advantage;
+	advantage << FcLayer(Matrix::Random(3, 16));
+
+	Network network;
+	network << FcLayer(Matrix::Random(16, 8)) << ReLULayer(Matrix::Random(16, 1));
+	network << DuelingHead(std::move(value), std::move(advantage));
+	// with the optimizer state in double
+	check_steady_state( std::move(network), 0.01, Schedule::cosine(0.001, 0.0001, 1000),
+						std::make_unique<BasicRMSProp<accum_t>>(0.9, 0.001, 0.01) );
+}
+
+// the first calls may explore without using the network, later greedy states still must not allocate
+BOOST_AUTO_TEST_CASE(epsilon_greedy_exploration_first)
+{
+	const std::size_t STATE_SIZE = 8, BATCH = 64;
+	Network network;
+	network << FcLayer(Matrix::Random(3, STATE_SIZE)) << TanhLayer(Matrix::Random(3, 1));
+	ComputationGraph graph( network );
+	graph.forward( Vector::Random(STATE_SIZE) );
+	Matrix states = Matrix::Random( STATE_SIZE, BATCH );
+
+	EpsilonGreedy policy( 3, util::Random( 1 ) );
+	policy.select( graph, states, 1.f );
+	BOOST_REQUIRE_EQUAL( policy.getGreedyCount(), 0u );
+
+	util::AllocationScope allocations;
+	policy.select( graph, states, 0.5f );
+	policy.select( graph, states, 0.f );
+	BOOST_CHECK_EQUAL( policy.getGreedyCount(), BATCH );
+	BOOST_CHECK_EQUAL( allocations.count(), 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "config.h"
+
+// actions for a batch of count games in the given step. Game i plays (step / hold + i) modulo action_count,
+// so every game keeps an action for hold steps and the games of a batch play different actions.
+inline std::vector<int> make_actions( std::size_t count, int step, int action_count, int hold )
+{
+	std::vector<int> actions( count );
+	for(std::size_t i = 0; i < count; ++i)
+		actions[i] = (step / hold + i) % action_count;
+	return actions;
+}
+
+// a game must not depend on the size of the batch or on how the batch is stepped. make( count, seed ) creates
+// a batch of games. A batch of 3 and one of 8 games with the same seed are played side by side, the larger one
+// stepped in two halves, and their first three games have to agree in states and rewards. After every step,
+// check( states, rewards ) receives the states of the large batch and the rewards of the small one, for the
+// checks that are specific to the game. Finally, a batch with another seed has to start differently.
+template<class Factory, class Check>
+void check_independent_games( Factory make, int action_count, int hold, Eigen::Index state_size, Check check )
+{
+	auto small = make( 3, 17 );
+	auto large = make( 8, 17 );
+	std::vector<float> small_rewards( 3 ), large_rewards( 8 );
+	Matrix small_states, large_states;
+
+	for(int step = 0; step < 2000; ++step)
+	{
+		auto actions = make_actions( 8, step, action_count, hold );
+		small.step( actions.data(), small_rewards.data() );
+		large.step( actions.data(), large_rewards.data(), 0, 4 );
+		large.step( actions.data(), large_rewards.data(), 4, 8 );
+
+		small.getStates( small_states );
+		large.getStates( large_states );
+		BOOST_REQUIRE_EQUAL( small_states.rows(), state_size );
+		BOOST_REQUIRE_EQUAL( small_states.cols(), 3 );
+		BOOST_REQUIRE( small_states == large_states.leftCols( 3 ) );
+		for(std::size_t i = 0; i < 3; ++i)
+			BOOST_REQUIRE_EQUAL( small_rewards[i], large_rewards[i] );
+
+		check( large_states, small_rewards );
+	}
+
+	// other seeds give other games
+	Matrix first, other;
+	make( 3, 17 ).getStates( first );
+	make( 3, 18 ).getStates( other );
+	BOOST_CHECK( first != other );
+}
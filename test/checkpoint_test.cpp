@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+#include "net/checkpoint.hpp"
+#include "net/checkpoint_writer.hpp"
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/dueling_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+
+using namespace net;
+
+BOOST_AUTO_TEST_SUITE(checkpoint)
+
+Network make_network()
+{
+	Network value;
+	value << FcLayer(Matrix::Random(1, 4));
+	Network advantage;
+	advantage << FcLayer(Matrix::Random(3, 4));
+
+	Network network;
+	network << FcLayer(Matrix::Random(4, 5)) << TanhLayer(Matrix::Random(4, 1));
+	network << DuelingHead(std::move(value), std::move(advantage));
+	return network;
+}
+
+BOOST_AUTO_TEST_CASE(roundtrip)
+{
+	const char* path = "checkpoint_test.bin";
+
+	Network network = make_network();
+	Solver solver( std::make_unique<RMSProp>(0.9, 0.001, 0.01) );
+	const Matrix& first = *network.getParameters()[0];
+	solver.getUpdateRule().setState( first, Matrix::Constant(first.rows(), first.cols(), 0.5) );
+
+	Checkpoint( network, &solver ).counter( "steps", 1234 ).write( path );
+
+	{
+		MappedCheckpoint loaded( path );
+		BOOST_CHECK_EQUAL( loaded.getParameterCount(), network.getParameters().size() );
+		BOOST_CHECK_EQUAL( loaded.getCounter("steps"), 1234u );
+		BOOST_CHECK_EQUAL( loaded.getCounter("missing", 7), 7u );
+		BOOST_CHECK( loaded.hasState(0) );
+		BOOST_CHECK( !loaded.hasState(1) );
+		// indices past the parameter table are rejected
+		const std::size_t count = loaded.getParameterCount();
+		BOOST_CHECK_THROW( loaded.getParameter( count ), std::out_of_range );
+		BOOST_CHECK_THROW( loaded.hasState( count ), std::out_of_range );
+		BOOST_CHECK_THROW( loaded.getState( count ), std::out_of_range );
+
+		// rebuild from topology
+		Network rebuilt = loaded.network();
+		BOOST_REQUIRE( rebuilt.is_compatible( network ) );
+		for(std::size_t i = 0; i < network.getParameters().size(); ++i)
+		{
+			BOOST_CHECK( *rebuilt.getParameters()[i] == *network.getParameters()[i] );
+		}
+
+		// restore into an existing network and solver
+		Network other = make_network();
+		Solver other_solver( std::make_unique<RMSProp>(0.9, 0.001, 0.01) );
+		loaded.restore( other, &other_solver );
+		BOOST_CHECK( *other.getParameters()[2] == *network.getParameters()[2] );
+		const Matrix& restored = *other.getParameters()[0];
+		Matrix state( restored.rows(), restored.cols() );
+		BOOST_REQUIRE( other_solver.getUpdateRule().getState( restored, state ) );
+		BOOST_CHECK_EQUAL( state(0, 0), 0.5f );
+
+		// incompatible networks are rejected
+		Network small;
+		small << FcLayer(Matrix::Random(2, 2));
+		BOOST_CHECK_THROW( loaded.restore( small ), std::invalid_argument );
+	}
+
+	std::remove( path );
+}
+
+BOOST_AUTO_TEST_CASE(invalid_file)
+{
+	const char* path = "checkpoint_invalid.bin";
+	std::vector<char> garbage(256, 'x');
+	writeFile( path, garbage.data(), garbage.size() );
+	BOOST_CHECK_THROW( MappedCheckpoint{path}, std::runtime_error );
+	std::remove( path );
+}
+
+BOOST_AUTO_TEST_CASE(async_writer)
+{
+	const char* path = "checkpoint_async.bin";
+	Network network = make_network();
+	Checkpoint snapshot( network );
+	snapshot.counter( "steps", 42 );
+
+	AsyncCheckpointWriter writer;
+	BOOST_REQUIRE( writer.submit( snapshot, path ) );
+	// changes after the submission must not end up in the file
+	network.getParameters()[0]->setZero();
+	writer.wait();
+	BOOST_CHECK( !writer.busy() );
+	BOOST_CHECK_EQUAL( writer.getLastError(), "" );
+
+	MappedCheckpoint loaded( path );
+	BOOST_CHECK_EQUAL( loaded.getCounter("steps"), 42u );
+	BOOST_CHECK( !loaded.getParameter(0).isZero() );
+	std::remove( path );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
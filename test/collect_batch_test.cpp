@@ -0,0 +1,44 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "games/collect_batch.h"
+#include "batch_games.hpp"
+
+BOOST_AUTO_TEST_SUITE(collect_batch)
+
+// a game must not depend on the size of the batch or on how the batch is stepped
+BOOST_AUTO_TEST_CASE(independent_games)
+{
+	float total = 0;
+	check_independent_games( []( std::size_t count, std::uint64_t seed ) { return CollectBatch( count, seed ); },
+							 collect::NUM_ACTIONS, 10, collect::STATE_SIZE,
+							 [&]( const Matrix& states, const std::vector<float>& rewards )
+	{
+		for(float reward : rewards)
+			total += std::abs( reward );
+		BOOST_REQUIRE( (states.array() > 0).all() );
+		BOOST_REQUIRE( (states.array() <= collect::SENSOR_RANGE).all() );
+	} );
+	// the agents do run into objects
+	BOOST_CHECK( total > 0 );
+}
+
+BOOST_AUTO_TEST_CASE(wrap_around)
+{
+	CollectBatch batch( 4, 1 );
+	std::vector<int> actions( 4, 0 );
+	std::vector<float> rewards( 4 );
+	for(int step = 0; step < 500; ++step)
+	{
+		batch.step( actions.data(), rewards.data() );
+		for(std::size_t i = 0; i < batch.size(); ++i)
+		{
+			BOOST_REQUIRE( batch.getX(i) >= 0 && batch.getX(i) <= 1 );
+			BOOST_REQUIRE( batch.getY(i) >= 0 && batch.getY(i) <= 1 );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+
+#include "net/network.hpp"
+#include "net/computation_graph.hpp"
+#include "net/fc_layer.hpp"
+#include "net/dueling_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+
+using namespace net;
+
+BOOST_AUTO_TEST_SUITE(dueling)
+
+const Matrix& fc_parameter( const Network& network, std::size_t layer )
+{
+	return dynamic_cast<const FcLayer&>( *network.getLayers()[layer] ).getParameter();
+}
+
+void check_close( const Matrix& a, const Matrix& b )
+{
+	BOOST_REQUIRE_EQUAL( a.rows(), b.rows() );
+	BOOST_REQUIRE_EQUAL( a.cols(), b.cols() );
+	BOOST_CHECK_MESSAGE( (a - b).cwiseAbs().maxCoeff() < 1e-5, "\n" << a << "\n!=\n" << b );
+}
+
+Network make_head()
+{
+	Network value;
+	value << FcLayer( Matrix::Random(1, 4) );
+	Network advantage;
+	advantage << FcLayer( Matrix::Random(3, 4) );
+	Network network;
+	network << FcLayer( Matrix::Random(4, 5) );
+	network << DuelingHead( std::move(value), std::move(advantage) );
+	return network;
+}
+
+BOOST_AUTO_TEST_CASE(forward)
+{
+	Network network = make_head();
+	const auto& head = dynamic_cast<const DuelingHead&>( *network.getLayers()[1] );
+	const Matrix& W = fc_parameter( network, 0 );
+	const Matrix& V = fc_parameter( head.getValueStream(), 0 );
+	const Matrix& A = fc_parameter( head.getAdvantageStream(), 0 );
+
+	ComputationGraph graph( network );
+	Vector input = Vector::Random(5);
+	Vector hidden = W * input;
+	Vector advantage = A * hidden;
+	Vector expected = (V * hidden)(0) + advantage.array() - advantage.mean();
+
+	BOOST_CHECK_EQUAL( network.getOutputSize(), 3u );
+	check_close( graph.forward( input ), expected );
+	// cached nodes are reused by a second evaluation
+	check_close( graph.forward( input ), expected );
+}
+
+BOOST_AUTO_TEST_CASE(backpropagate)
+{
+	Network network = make_head();
+	const auto& head = dynamic_cast<const DuelingHead&>( *network.getLayers()[1] );
+	const Matrix& W = fc_parameter( network, 0 );
+	const Matrix& V = fc_parameter( head.getValueStream(), 0 );
+	const Matrix& A = fc_parameter( head.getAdvantageStream(), 0 );
+
+	ComputationGraph graph( network );
+	Solver solver( std::make_unique<RMSProp>(0.9, 0.001, 0.01) );
+	Vector input = Vector::Random(5);
+	Vector error = Vector::Random(3);
+	graph.forward( input );
+	graph.backpropagate( error, solver );
+
+	// q = V h + A h - mean(A h) with h = W x, so dq/dv sums the error and dq/da removes its mean
+	Vector hidden = W * input;
+	number_t value_error = error.sum();
+	Vector advantage_error = error.array() - error.mean();
+	Vector hidden_error = V.transpose() * value_error + A.transpose() * advantage_error;
+
+	const Solver& gradients = solver;
+	check_close( gradients.getGradient( V ), value_error * hidden.transpose() );
+	check_close( gradients.getGradient( A ), advantage_error * hidden.transpose() );
+	// the errors of both branches are summed up in the shared trunk
+	check_close( gradients.getGradient( W ), hidden_error * input.transpose() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
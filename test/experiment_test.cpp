@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include "qlearner/experiment.hpp"
+#include "net/network.hpp"
+#include "net/computation_graph.hpp"
+#include "net/dueling_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+
+using namespace net;
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(experiments)
+
+const char* PONG = R"({
+	"game": "pong",
+	"inputs": 30,
+	"actions": 3,
+	"learner": { "memory": 2000, "batch_size": 16, "discount_factor": 0.98, "seed": 7,
+				 "epsilon": { "type": "linear", "start": 1, "end": 0.1, "steps": 1000 },
+				 "target_tau": 0.01 },
+	"network": [ { "type": "fc", "size": 20 }, "tanh",
+				 { "type": "dueling", "value": [ { "type": "fc", "size": 1 } ],
+									  "advantage": [ { "type": "fc", "size": 3 } ] } ],
+	"optimizer": { "type": "rmsprop", "decay": 0.95, "rate": 0.0001, "epsilon": 1e-6 },
+	"threads": { "count": 2, "cores": [0] }
+})";
+
+BOOST_AUTO_TEST_CASE(load)
+{
+	auto experiment = Experiment::fromString( PONG );
+	BOOST_CHECK_EQUAL( experiment.game(), "pong" );
+	const Config& config = experiment.config();
+	BOOST_CHECK_EQUAL( config.input_size(), 30u );
+	BOOST_CHECK_EQUAL( config.action_count(), 3u );
+	BOOST_CHECK_EQUAL( config.memory(), 2000u );
+	BOOST_CHECK_EQUAL( config.batch_size(), 16u );
+	BOOST_CHECK_EQUAL( config.seed(), 7u );
+	BOOST_CHECK_CLOSE( config.gamma(), 0.98, 1e-9 );
+	BOOST_CHECK_CLOSE( config.getStepEpsilon( 500 ), 0.55, 1e-4 );
+	BOOST_CHECK_CLOSE( config.target_tau()( 0 ), 0.01, 1e-9 );
+	BOOST_CHECK( !config.learning_rate() );
+	BOOST_CHECK_EQUAL( experiment.threads().threads, 2u );
+	BOOST_REQUIRE_EQUAL( experiment.threads().cores.size(), 1u );
+
+	Network network = experiment.makeNetwork( 1 );
+	BOOST_REQUIRE_EQUAL( network.getLayers().size(), 3u );
+	BOOST_CHECK_EQUAL( network.getLayers()[2]->getLayerType(), std::string("dueling") );
+	BOOST_CHECK_EQUAL( network.getOutputSize(), 3u );
+	ComputationGraph graph( network );
+	BOOST_CHECK_EQUAL( graph.forward( Vector::Random(30) ).size(), 3 );
+
+	// the seed determines the initialization
+	BOOST_CHECK( *experiment.makeNetwork( 1 ).getParameters()[0] == *network.getParameters()[0] );
+	BOOST_CHECK( *experiment.makeNetwork( 2 ).getParameters()[0] != *network.getParameters()[0] );
+	// default scale is 1/sqrt(inputs)
+	BOOST_CHECK( network.getParameters()[0]->cwiseAbs().maxCoeff() <= 1 / std::sqrt( 30.f ) );
+
+	BOOST_CHECK( experiment.makeSolver() );
+	auto solver = experiment.with( {{"optimizer.state", "double"}} ).makeSolver();
+	BOOST_CHECK( dynamic_cast<BasicRMSProp<double>*>( &solver->getUpdateRule() ) );
+}
+
+void check_error( const std::string& json, const std::string& path )
+{
+	try
+	{
+		Experiment::fromString( json );
+		BOOST_ERROR( "no error for " << path );
+	} catch( std::invalid_argument& e )
+	{
+		BOOST_CHECK_MESSAGE( std::string( e.what() ).compare( 0, path.size() + 1, path + ":" ) == 0,
+							 "expected error at " << path << ", got " << e.what() );
+	}
+}
+
+// errors are found before training and name the offending entry
+BOOST_AUTO_TEST_CASE(validation)
+{
+	const std::string head = R"({ "inputs": 4, "actions": 2, )";
+	check_error( head + R"("network": [ { "type": "fc", "size": 3 } ] })", "network" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 }, "sigmoid" ] })", "network[1]" );
+	check_error( head + R"("network": [ { "type": "fc", "size": -2 } ] })", "network[0].size" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2, "bias": 1 } ] })", "network[0].bias" );
+	check_error( head + R"("network": [ { "type": "dueling", "value": [ { "type": "fc", "size": 2 } ],
+										  "advantage": [ { "type": "fc", "size": 2 } ] } ] })", "network[0].value" );
+	check_error( head + R"("network": [ { "type": "fc" } ] })", "network[0].size" );
+	check_error( head + R"("netwrk": [] })", "netwrk" );
+	check_error( R"({ "inputs": 4, "actions": 2 })", "network" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "learner": { "batch": 3 } })", "learner.batch" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "learner": { "discount_factor": 1.5 } })", "learner.discount_factor" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "learner": { "batch_size": "many" } })", "learner.batch_size" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ],
+							"learner": { "epsilon": { "type": "piecewise", "segments": [ { "from": 5, "schedule": 1 } ] } } })",
+				 "learner.epsilon.segments[0]" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "learner": { "target_tau": { "type": "step" } } })",
+				 "learner.target_tau.type" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "learner": { "target_tau": -0.5 } })",
+				 "learner.target_tau" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "optimizer": { "type": "adam" } })", "optimizer.type" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "optimizer": { "type": "rmsprop", "state": "half" } })",
+				 "optimizer.state" );
+	check_error( head + R"("network": [ { "type": "fc", "size": 2 } ], "threads": { "count": 0 } })", "threads.count" );
+	check_error( R"({ "inputs": 4, "network": [] })", "actions" );
+
+	BOOST_CHECK_THROW( Experiment::fromString( "{ \"inputs\": " ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+
+#include "net/gradient_check.hpp"
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/relu_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/dueling_layer.hpp"
+#include "util/random.hpp"
+
+using namespace net;
+
+BOOST_AUTO_TEST_SUITE(gradients)
+
+Matrix random_matrix( std::size_t rows, std::size_t cols, std::uint64_t seed, float scale = 1 )
+{
+	util::Random random( seed );
+	Matrix m( rows, cols );
+	for(Eigen::Index i = 0; i < m.size(); ++i)
+		m.data()[i] = (2 * random.uniform() - 1) * scale;
+	return m;
+}
+
+void check( const GradientCheckResult& result, std::size_t expected_count )
+{
+	BOOST_CHECK_EQUAL( result.checked, expected_count );
+	BOOST_CHECK_MESSAGE( result.max_error < gradient_tolerance(), "error " << result.max_error << " at " << result.worst
+						 << " exceeds " << gradient_tolerance() );
+}
+
+BOOST_AUTO_TEST_CASE(layers)
+{
+	for(std::uint64_t seed = 1; seed <= 5; ++seed)
+	{
+		GradientCheckOptions options;
+		options.seed = seed;
+		check( check_layer_gradients( FcLayer( random_matrix( 7, 5, seed ) ), 5, options ), 7 * 5 + 5 );
+		check( check_layer_gradients( TanhLayer( random_matrix( 6, 1, seed ) ), 6, options ), 6 + 6 );
+		check( check_layer_gradients( ReLULayer( random_matrix( 6, 1, seed ) ), 6, options ), 6 + 6 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(networks)
+{
+	Network mlp;
+	mlp << FcLayer( random_matrix( 12, 6, 1, 0.5 ) ) << ReLULayer( random_matrix( 12, 1, 2 ) );
+	mlp << FcLayer( random_matrix( 8, 12, 3, 0.5 ) ) << TanhLayer( random_matrix( 8, 1, 4 ) );
+	mlp << FcLayer( random_matrix( 3, 8, 5, 0.5 ) );
+	check( check_network_gradients( mlp, 6 ), 12 * 6 + 12 + 8 * 12 + 8 + 3 * 8 );
+
+	Network value;
+	value << FcLayer( random_matrix( 1, 10, 6 ) );
+	Network advantage;
+	advantage << FcLayer( random_matrix( 4, 10, 7 ) ) << TanhLayer( random_matrix( 4, 1, 8 ) );
+	Network dueling;
+	dueling << FcLayer( random_matrix( 10, 6, 9, 0.5 ) ) << TanhLayer( random_matrix( 10, 1, 10 ) );
+	dueling << DuelingHead( std::move(value), std::move(advantage) );
+	check( check_network_gradients( dueling, 6 ), 10 * 6 + 10 + 10 + 4 * 10 + 4 );
+}
+
+// a layer whose input gradient is off by 10%
+class BrokenTanh : public TanhLayer
+{
+public:
+	using TanhLayer::TanhLayer;
+	void backward( const Vector& error, Vector& back, const ComputationNode& compute, Solver& solver ) const override
+	{
+		TanhLayer::backward( error, back, compute, solver );
+		back *= 1.1f;
+	}
+	std::unique_ptr<ILayer> clone() const override { return std::make_unique<BrokenTanh>( *this ); }
+};
+
+BOOST_AUTO_TEST_CASE(detects_errors)
+{
+	auto result = check_layer_gradients( BrokenTanh( random_matrix( 4, 1, 1 ) ), 4 );
+	BOOST_CHECK( result.max_error > 10 * gradient_tolerance() );
+	BOOST_CHECK_EQUAL( result.worst.compare( 0, 5, "input" ), 0 );
+
+	// the wrong input gradient also shows up in the parameters of the layers before it
+	Network network;
+	network << FcLayer( random_matrix( 4, 3, 2 ) ) << BrokenTanh( random_matrix( 4, 1, 3 ) );
+	BOOST_CHECK( check_network_gradients( network, 3 ).max_error > 10 * gradient_tolerance() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "qlearner/memory.hpp"
+#include "net/checkpoint_writer.hpp"
+
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_AUTO_TEST_CASE(save_load)
+{
+	const char* path = "memory_test.bin";
+	MemoryCache memory(10);
+	for(int i = 0; i < 15; ++i)
+	{
+		memory.emplace( Vector::Constant(4, i), i % 3, Vector::Constant(4, i + 1), i * 0.5f, i % 2 == 0 );
+	}
+	memory.save( path );
+
+	MemoryCache restored(10);
+	restored.load( path );
+	BOOST_REQUIRE_EQUAL( restored.size(), memory.size() );
+	for(std::size_t i = 0; i < memory.size(); ++i)
+	{
+		const Experience& a = memory.get(i);
+		const Experience& b = restored.get(i);
+		BOOST_CHECK( a.situation == b.situation );
+		BOOST_CHECK( a.future == b.future );
+		BOOST_CHECK_EQUAL( a.action, b.action );
+		BOOST_CHECK_EQUAL( a.reward, b.reward );
+		BOOST_CHECK_EQUAL( a.terminal, b.terminal );
+	}
+
+	// a smaller memory keeps only the newest experiences
+	MemoryCache small(3);
+	small.load( path );
+	BOOST_REQUIRE_EQUAL( small.size(), 3u );
+	BOOST_CHECK( small.get(2).situation == memory.get(9).situation );
+	BOOST_CHECK( small.get(0).situation == memory.get(7).situation );
+
+	std::remove( path );
+}
+
+// the snapshot taken for the background writer matches save(), and is not affected by later experiences
+BOOST_AUTO_TEST_CASE(async_snapshot)
+{
+	const char* path = "memory_test_sync.bin";
+	const char* async_path = "memory_test_async.bin";
+	MemoryCache memory(10);
+	for(int i = 0; i < 15; ++i)
+		memory.emplace( Vector::Constant(4, i), i % 3, Vector::Constant(4, i + 1), i * 0.5f, i % 2 == 0 );
+	memory.save( path );
+
+	net::AsyncCheckpointWriter writer;
+	BOOST_REQUIRE( writer.submit( memory, async_path ) );
+	for(int i = 0; i < 5; ++i)
+		memory.emplace( Vector::Constant(4, -i), 0, Vector::Constant(4, -i), -1.f, false );
+	writer.wait();
+	BOOST_CHECK_EQUAL( writer.getLastError(), "" );
+
+	std::ifstream sync_file( path, std::ios::binary );
+	std::ifstream async_file( async_path, std::ios::binary );
+	std::vector<char> expected( (std::istreambuf_iterator<char>(sync_file)), std::istreambuf_iterator<char>() );
+	std::vector<char> written( (std::istreambuf_iterator<char>(async_file)), std::istreambuf_iterator<char>() );
+	BOOST_CHECK( expected == written );
+
+	MemoryCache restored(10);
+	restored.load( async_path );
+	BOOST_REQUIRE_EQUAL( restored.size(), 10u );
+	BOOST_CHECK( restored.get(9).situation == Vector::Constant(4, 14) );
+
+	std::remove( path );
+	std::remove( async_path );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,155 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "util/metrics.hpp"
+#include "util/metrics_server.hpp"
+#include "util/series_writer.hpp"
+
+using namespace metrics;
+
+BOOST_AUTO_TEST_SUITE(metrics_export)
+
+BOOST_AUTO_TEST_CASE(prometheus_format)
+{
+	Registry registry;
+	registry.counter( "steps_total", "steps" ).add( 42 );
+	registry.gauge( "fill", "fill level" ).set( 0.25 );
+	Histogram& latency = registry.histogram( "latency_seconds", "latency", {0.1, 1} );
+	latency.observe( 0.05 );
+	latency.observe( 0.5 );
+	latency.observe( 3 );
+	BOOST_CHECK_THROW( registry.gauge( "fill", "again" ), std::invalid_argument );
+
+	std::ostringstream out;
+	registry.writePrometheus( out );
+	std::string text = out.str();
+	for(const char* line : {"# TYPE steps_total counter\nsteps_total 42\n", "fill 0.25\n",
+							"latency_seconds_bucket{le=\"0.1\"} 1\n", "latency_seconds_bucket{le=\"1\"} 2\n",
+							"latency_seconds_bucket{le=\"+Inf\"} 3\n", "latency_seconds_sum 3.55\n",
+							"latency_seconds_count 3\n"})
+	{
+		BOOST_CHECK_MESSAGE( text.find( line ) != std::string::npos, "missing: " << line );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(csv_series)
+{
+	const char* path = "metrics_test.csv";
+	{
+		SeriesWriter writer( path, {"a", "b"} );
+		for(int i = 0; i < 10; ++i)
+			BOOST_REQUIRE( writer.record({double(i), 0.5 * i}) );
+		writer.flush();
+	}
+	std::ifstream in( path );
+	std::string line;
+	std::getline( in, line );
+	BOOST_CHECK_EQUAL( line, "time,a,b" );
+	int rows = 0;
+	while( std::getline( in, line ) )
+	{
+		double time, a, b;
+		BOOST_REQUIRE_EQUAL( std::sscanf( line.c_str(), "%lf,%lf,%lf", &time, &a, &b ), 3 );
+		BOOST_CHECK_EQUAL( a, rows );
+		BOOST_CHECK_EQUAL( b, 0.5 * rows );
+		++rows;
+	}
+	BOOST_CHECK_EQUAL( rows, 10 );
+	std::remove( path );
+}
+
+// a writer that cannot keep up drops rows instead of blocking
+BOOST_AUTO_TEST_CASE(binary_series_drops)
+{
+	const char* path = "metrics_test.bin";
+	std::size_t written = 0;
+	const std::size_t RECORDS = 10000;
+	std::size_t dropped = 0;
+	{
+		SeriesWriter writer( path, {"x"}, SeriesWriter::Format::BINARY, 16 );
+		for(std::size_t i = 0; i < RECORDS; ++i)
+			written += writer.record({double(i)});
+		dropped = writer.getDropped();
+	}
+	BOOST_CHECK_EQUAL( written + dropped, RECORDS );
+	BOOST_CHECK( dropped > 0 );
+
+	std::ifstream in( path, std::ios::binary );
+	char magic[9];
+	in.read( magic, 9 );
+	BOOST_CHECK( std::memcmp( magic, "DQNSERIES", 9 ) == 0 );
+	std::uint32_t columns;
+	in.read( (char*)&columns, sizeof(columns) );
+	BOOST_CHECK_EQUAL( columns, 2u );
+	char names[7];
+	in.read( names, 7 );
+	BOOST_CHECK( std::memcmp( names, "time\0x\0", 7 ) == 0 );
+	double row[2], last = -1;
+	std::size_t rows = 0;
+	while( in.read( (char*)row, sizeof(row) ) )
+	{
+		BOOST_REQUIRE( row[1] > last );
+		last = row[1];
+		++rows;
+	}
+	BOOST_CHECK_EQUAL( rows, written );
+	std::remove( path );
+}
+
+std::string http_get( int fd )
+{
+	const char request[] = "GET /metrics HTTP/1.0\r\n\r\n";
+	BOOST_REQUIRE( ::send( fd, request, sizeof(request) - 1, 0 ) > 0 );
+	std::string response;
+	char buffer[1024];
+	ssize_t n;
+	while( (n = ::recv( fd, buffer, sizeof(buffer), 0 )) > 0 )
+		response.append( buffer, n );
+	::close( fd );
+	return response;
+}
+
+BOOST_AUTO_TEST_CASE(server)
+{
+	Registry registry;
+	registry.counter( "served_total", "test counter" ).add( 7 );
+
+	{
+		MetricsServer server( registry, 0 );
+		BOOST_REQUIRE( server.getPort() > 0 );
+		int fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+		sockaddr_in address;
+		std::memset( &address, 0, sizeof(address) );
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		address.sin_port = htons( server.getPort() );
+		BOOST_REQUIRE( ::connect( fd, (sockaddr*)&address, sizeof(address) ) == 0 );
+		std::string response = http_get( fd );
+		BOOST_CHECK( response.compare( 0, 15, "HTTP/1.0 200 OK" ) == 0 );
+		BOOST_CHECK( response.find( "served_total 7\n" ) != std::string::npos );
+	}
+
+	{
+		const char* path = "metrics_test.sock";
+		MetricsServer server( registry, std::string(path) );
+		int fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+		sockaddr_un address;
+		std::memset( &address, 0, sizeof(address) );
+		address.sun_family = AF_UNIX;
+		std::strcpy( address.sun_path, path );
+		BOOST_REQUIRE( ::connect( fd, (sockaddr*)&address, sizeof(address) ) == 0 );
+		BOOST_CHECK( http_get( fd ).find( "served_total 7\n" ) != std::string::npos );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
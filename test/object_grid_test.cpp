@@ -0,0 +1,61 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+
+#include "games/object_grid.h"
+
+BOOST_AUTO_TEST_SUITE(object_grid)
+
+const float RADIUS = 0.04;
+const float RANGE = 0.3;
+
+// the grid has to find exactly the same closest hit as testing all objects
+BOOST_AUTO_TEST_CASE(matches_brute_force)
+{
+	std::mt19937 random( 5 );
+	std::uniform_real_distribution<float> pos( 0, 1 );
+	std::uniform_real_distribution<float> angle( 0, 6.2831853f );
+
+	for(int count : {1, 10, 100})
+	{
+		ObjectArrays objects;
+		objects.resize( count );
+		for(int i = 0; i < count; ++i)
+		{
+			float x = pos(random);
+			objects.set( i, x, pos(random), 0 );
+		}
+
+		for(int cells : {1, 4, 8, 13})
+		{
+			ObjectGrid grid( cells, RADIUS );
+			grid.build( objects );
+			for(int ray = 0; ray < 2000; ++ray)
+			{
+				float sx = pos(random);
+				float sy = pos(random);
+				float a = ray % 50 == 0 ? ray / 50 * 1.5707963f : angle(random);
+				float lx = std::cos(a);
+				float ly = std::sin(a);
+
+				auto hit = [&]( int i ) { return hitTest( sx, sy, lx, ly, objects.x(i), objects.y(i), RADIUS ); };
+				float expected = RANGE;
+				for(int i = 0; i < count; ++i)
+					expected = std::min( expected, hit(i) );
+
+				float result = grid.cast( sx, sy, lx, ly, RANGE, hit );
+				BOOST_REQUIRE_EQUAL( result, expected );
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+	ObjectGrid grid( 8, RADIUS );
+	grid.build( ObjectArrays() );
+	BOOST_CHECK_EQUAL( grid.cast( 0.5, 0.5, 1, 0, RANGE, []( int ) { return 0.f; } ), RANGE );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "games/pong.h"
+#include "games/pong_batch.h"
+#include "batch_games.hpp"
+
+BOOST_AUTO_TEST_SUITE(pong_batch)
+
+// a game must not depend on the size of the batch or on how the batch is stepped
+BOOST_AUTO_TEST_CASE(independent_games)
+{
+	int finished = 0;
+	check_independent_games( []( std::size_t count, std::uint64_t seed ) { return PongBatch( count, seed, true ); },
+							 pong::NUM_ACTIONS, 7, pong::STATE_SIZE,
+							 [&]( const Matrix& states, const std::vector<float>& rewards )
+	{
+		for(float reward : rewards)
+			finished += reward != 0;
+		// one-hot encoding of ball and bat
+		BOOST_REQUIRE( (states.topRows( pong::STATE_STEPS ).colwise().sum().array() == 1).all() );
+		BOOST_REQUIRE( (states.bottomRows( pong::STATE_STEPS ).colwise().sum().array() == 1).all() );
+	} );
+	BOOST_CHECK( finished > 0 );
+}
+
+// the batch plays exactly like Pong started from the same positions
+BOOST_AUTO_TEST_CASE(same_rules_as_pong)
+{
+	PongBatch batch( 4, 3, true );
+	std::vector<Pong> games( batch.size(), Pong( true ) );
+	for(std::size_t i = 0; i < batch.size(); ++i)
+		games[i].setState( batch.getBallX(i), batch.getBallY(i), batch.getBallVY(i), batch.getBatY(i) );
+
+	std::vector<float> rewards( batch.size() );
+	Matrix states;
+	Vector state;
+	for(int step = 0; step < 300; ++step)
+	{
+		auto actions = make_actions( batch.size(), step, pong::NUM_ACTIONS, 7 );
+		batch.step( actions.data(), rewards.data() );
+		batch.getStates( states );
+		for(std::size_t i = 0; i < batch.size(); ++i)
+		{
+			float reward = games[i].step( actions[i] );
+			BOOST_REQUIRE_EQUAL( rewards[i], reward );
+			BOOST_REQUIRE_EQUAL( reward != 0, games[i].isFinished() );
+			if( games[i].isFinished() )
+			{
+				// continue with the restarted game of the batch
+				BOOST_REQUIRE_EQUAL( batch.getBallX(i), pong::START_X );
+				games[i].setState( batch.getBallX(i), batch.getBallY(i), batch.getBallVY(i), batch.getBatY(i) );
+			}
+			BOOST_REQUIRE_EQUAL( batch.getBallY(i), games[i].getBallY() );
+			BOOST_REQUIRE_EQUAL( batch.getBatY(i), games[i].getBatY() );
+			games[i].getCurrentState( state );
+			BOOST_REQUIRE( states.col(i) == state );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
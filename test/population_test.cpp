@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+#include "qlearner/population.hpp"
+#include "qlearner/qlearner.hpp"
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+#include "test_games.hpp"
+
+using namespace net;
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(population)
+
+BOOST_AUTO_TEST_CASE(copy_learner)
+{
+	auto experiment = base();
+	QLearner source( experiment.config(), experiment.makeNetwork( 1 ) );
+	QLearner target( experiment.config(), experiment.makeNetwork( 2 ) );
+	auto source_solver = experiment.makeSolver();
+	auto target_solver = experiment.makeSolver();
+	for(int i = 0; i < 200; ++i)
+		source.learn_step( Vector::Random(4), i % 3, false, *source_solver );
+
+	target.copy_parameters_from( source, *target_solver, *source_solver );
+	const auto& params = target.network().getParameters();
+	const auto& source_params = source.network().getParameters();
+	for(std::size_t i = 0; i < params.size(); ++i)
+	{
+		BOOST_CHECK( *params[i] == *source_params[i] );
+		Matrix state( params[i]->rows(), params[i]->cols() );
+		Matrix source_state( params[i]->rows(), params[i]->cols() );
+		BOOST_REQUIRE( target_solver->getUpdateRule().getState( *params[i], state ) );
+		BOOST_REQUIRE( source_solver->getUpdateRule().getState( *source_params[i], source_state ) );
+		BOOST_CHECK( state == source_state );
+	}
+	// replay memory and counters stay
+	BOOST_CHECK_EQUAL( target.getMemorySize(), 0u );
+
+	Config changed = experiment.config();
+	target.setConfig( changed.discount_factor( 0.5 ) );
+	BOOST_CHECK_EQUAL( target.config().gamma(), 0.5 );
+	BOOST_CHECK_THROW( target.setConfig( Config( 4, 2, 100 ) ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE(exploit_and_explore)
+{
+	SearchSpace space;
+	space.choice( "learner.discount_factor", {0.9, 0.8, 0.7, 0.1} );
+
+	PopulationOptions options;
+	options.steps = 400;
+	options.interval = 200;
+	options.truncation = 0.25;
+	options.perturbation = 2;
+	options.workers = 2;
+	PopulationTrainer trainer( base(), make_game, options );
+	trainer.run( space.grid() );
+	BOOST_REQUIRE_EQUAL( trainer.size(), 4u );
+	BOOST_CHECK_EQUAL( trainer.getBest(), 0u );
+
+	// only the worst member was replaced, by a perturbed copy of the best one
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		BOOST_CHECK_CLOSE( trainer.getLearningRate( i ), 0.01, 1e-9 );
+	}
+	double rate = trainer.getLearningRate( 3 );
+	BOOST_CHECK( std::abs( rate - 0.02 ) < 1e-9 || std::abs( rate - 0.005 ) < 1e-9 );
+	double gamma = trainer.getDiscountFactor( 3 );
+	BOOST_CHECK( std::abs( gamma - 0.8 ) < 1e-6 || std::abs( gamma - 0.95 ) < 1e-6 );
+	BOOST_CHECK_EQUAL( trainer.getLearner( 3 ).config().gamma(), gamma );
+
+	std::ostringstream table;
+	trainer.writeTable( table );
+	std::istringstream lines( table.str() );
+	std::string line;
+	std::getline( lines, line );
+	BOOST_CHECK_EQUAL( line, "member,learning_rate,discount_factor,reward,copies,parent" );
+	for(int i = 0; i < 4; ++i)
+		std::getline( lines, line );
+	BOOST_CHECK( line.compare( line.size() - 4, 4, ",1,0" ) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE(incompatible_members)
+{
+	SearchSpace space;
+	space.choice( "network[0].size", {8, 16} );
+	PopulationTrainer trainer( base(), make_game, PopulationOptions() );
+	BOOST_CHECK_THROW( trainer.run( space.grid() ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
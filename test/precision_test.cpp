@@ -0,0 +1,120 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+#include "net/checkpoint.hpp"
+#include "util/random.hpp"
+
+using namespace net;
+
+BOOST_AUTO_TEST_SUITE(precision)
+
+BOOST_AUTO_TEST_CASE(rmsprop_state)
+{
+	const double LAMBDA = 0.99, RATE = 0.01, EPSILON = 1e-6;
+	util::Random random( 5 );
+	Matrix start( 8, 8 );
+	for(Eigen::Index i = 0; i < start.size(); ++i)
+		start.data()[i] = 2 * random.uniform() - 1;
+
+	Matrix single = start;
+	Matrix mixed = start;
+	MatrixT<double> reference = start.cast<double>();
+	MatrixT<double> reference_rms = reference.array().square();
+	BasicRMSProp<float> single_rule( LAMBDA, RATE, EPSILON );
+	BasicRMSProp<double> mixed_rule( LAMBDA, RATE, EPSILON );
+
+	for(int step = 0; step < 200; ++step)
+	{
+		Matrix gradient( 8, 8 );
+		for(Eigen::Index i = 0; i < gradient.size(); ++i)
+			gradient.data()[i] = (2 * random.uniform() - 1) * 1e-3;
+		single_rule.updateParameter( single, gradient );
+		mixed_rule.updateParameter( mixed, gradient );
+
+		MatrixT<double> g = gradient.cast<double>();
+		reference_rms = LAMBDA * reference_rms + (1 - LAMBDA) * g.array().square().matrix();
+		reference -= (RATE * g.array() / (reference_rms.array() + EPSILON).sqrt()).matrix();
+	}
+
+	// both follow the double precision reference, the double state more closely
+	double single_error = (single.cast<double>() - reference).cwiseAbs().maxCoeff();
+	double mixed_error = (mixed.cast<double>() - reference).cwiseAbs().maxCoeff();
+	BOOST_CHECK_LT( single_error, 1e-4 );
+	BOOST_CHECK_LE( mixed_error, single_error );
+	BOOST_CHECK_LT( mixed_error, 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE(state_conversion)
+{
+	Matrix parameter = Matrix::Constant( 3, 2, 0.5f );
+	BasicRMSProp<double> rule( 0.9, 0.001, 0.01 );
+	Matrix state( 3, 2 );
+	BOOST_CHECK( !rule.hasState( parameter ) );
+	BOOST_CHECK( !rule.getState( parameter, state ) );
+
+	rule.setState( parameter, Matrix::Constant( 3, 2, 0.25f ) );
+	BOOST_CHECK( rule.hasState( parameter ) );
+	BOOST_REQUIRE( rule.getState( parameter, state ) );
+	BOOST_CHECK( state == Matrix::Constant( 3, 2, 0.25f ) );
+}
+
+BOOST_AUTO_TEST_CASE(state_copy)
+{
+	Matrix parameter = Matrix::Constant( 3, 2, 0.5f );
+	Matrix gradient( 3, 2 );
+	gradient << 0.1f, -0.3f, 0.7f, 1e-4f, -2.f, 0.f;
+	BasicRMSProp<double> source( 0.9, 0.001, 0.01 );
+	for(int step = 0; step < 5; ++step)
+		source.updateParameter( parameter, gradient );
+
+	// between rules of the same type the state is copied in its own precision
+	Matrix copy = Matrix::Zero( 3, 2 );
+	BasicRMSProp<double> same( 0.9, 0.001, 0.01 );
+	BOOST_REQUIRE( same.copyState( copy, source, parameter ) );
+	BOOST_REQUIRE( same.findState( copy ) );
+	BOOST_CHECK( *same.findState( copy ) == *source.findState( parameter ) );
+
+	// other rules receive it as number_t
+	BasicRMSProp<float> other( 0.9, 0.001, 0.01 );
+	BOOST_REQUIRE( other.copyState( copy, source, parameter ) );
+	BOOST_CHECK( *other.findState( copy ) == source.findState( parameter )->cast<number_t>().cast<float>() );
+
+	// nothing to copy
+	Matrix fresh( 3, 2 );
+	BOOST_CHECK( !same.copyState( copy, source, fresh ) );
+	BOOST_CHECK( !same.findState( fresh ) );
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_across_precisions)
+{
+	const char* path = "precision_checkpoint.bin";
+	Network network;
+	network << FcLayer( Matrix::Random( 4, 3 ) ) << TanhLayer( Matrix::Random( 4, 1 ) );
+	Solver solver( std::make_unique<BasicRMSProp<double>>( 0.9, 0.001, 0.01 ) );
+	const Matrix& first = *network.getParameters()[0];
+	solver.getUpdateRule().setState( first, Matrix::Constant( first.rows(), first.cols(), 0.75f ) );
+	Checkpoint( network, &solver ).write( path );
+
+	{
+		// the state is saved in number_t, so it can be restored into a rule of any precision
+		MappedCheckpoint loaded( path );
+		BOOST_CHECK( loaded.hasState( 0 ) );
+		BOOST_CHECK( !loaded.hasState( 1 ) );
+		Network other = loaded.network();
+		Solver other_solver( std::make_unique<BasicRMSProp<float>>( 0.9, 0.001, 0.01 ) );
+		loaded.restore( other, &other_solver );
+		const Matrix& restored = *other.getParameters()[0];
+		Matrix state( restored.rows(), restored.cols() );
+		BOOST_REQUIRE( other_solver.getUpdateRule().getState( restored, state ) );
+		BOOST_CHECK( state == Matrix::Constant( restored.rows(), restored.cols(), 0.75f ) );
+	}
+	std::remove( path );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "util/random.hpp"
+#include "qlearner/qlearner.hpp"
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/tanh_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+#include "games/pong.h"
+
+using namespace net;
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(random_numbers)
+
+BOOST_AUTO_TEST_CASE(streams)
+{
+	util::Random a( 5 ), b( 5 ), other_seed( 6 ), other_stream( 5, 1 );
+	util::Random split = a.split( 1 ), split_again = b.split( 1 );
+	for(int i = 0; i < 100; ++i)
+	{
+		auto x = a();
+		BOOST_REQUIRE_EQUAL( x, b() );
+		BOOST_REQUIRE( x != other_seed() );
+		BOOST_REQUIRE( x != other_stream() );
+		BOOST_REQUIRE_EQUAL( split(), split_again() );
+	}
+}
+
+BOOST_AUTO_TEST_CASE(distributions)
+{
+	util::Random random( 1 );
+	const int N = 100000;
+	std::vector<int> counts( 7, 0 );
+	int hits = 0;
+	for(int i = 0; i < N; ++i)
+	{
+		float u = random.uniform();
+		BOOST_REQUIRE( u >= 0 && u < 1 );
+		std::uint32_t k = random.uniform_int( 7 );
+		BOOST_REQUIRE( k < 7 );
+		++counts[k];
+		hits += random.bernoulli( 0.25 );
+		BOOST_REQUIRE( !random.bernoulli( 0 ) );
+		BOOST_REQUIRE( random.bernoulli( 1 ) );
+	}
+	for(int c : counts)
+		BOOST_CHECK_CLOSE( c, N / 7.0, 3 );
+	BOOST_CHECK_CLOSE( hits, N / 4.0, 3 );
+}
+
+// two learners with the same seed, network and game make exactly the same decisions
+BOOST_AUTO_TEST_CASE(reproducible_learning)
+{
+	Network network;
+	network << FcLayer(Matrix::Random(3, pong::STATE_SIZE) / 5) << TanhLayer(Matrix::Zero(3, 1));
+
+	auto run = [&]( std::uint64_t seed )
+	{
+		QLearner learner( Config( pong::STATE_SIZE, pong::NUM_ACTIONS, 500 ).init_memory_size(100)
+																			 .init_epsilon_time(200)
+																			 .epsilon_steps(500)
+																			 .seed(seed), network.clone() );
+		Solver solver( std::make_unique<RMSProp>(0.9, 0.001, 0.01) );
+		Pong game( true, seed );
+		Vector state;
+		std::vector<int> actions;
+		float reward = 0;
+		for(int i = 0; i < 2000; ++i)
+		{
+			game.getCurrentState( state );
+			actions.push_back( learner.learn_step( state, reward, game.isFinished(), solver ) );
+			if( game.isFinished() )
+				game.restart();
+			reward = game.step( actions.back() );
+		}
+		return actions;
+	};
+
+	BOOST_CHECK( run( 3 ) == run( 3 ) );
+	BOOST_CHECK( run( 3 ) != run( 4 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
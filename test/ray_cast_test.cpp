@@ -0,0 +1,82 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+
+#include "games/ray_cast.h"
+
+BOOST_AUTO_TEST_SUITE(ray_cast)
+
+const float RADIUS = 0.04;
+const float RANGE = 0.3;
+
+// the SIMD kernel has to agree with the scalar hitTest, for every ray and type. The vectorized code may
+// round differently (and the release build uses -Ofast), so only a small relative difference is allowed.
+BOOST_AUTO_TEST_CASE(matches_scalar)
+{
+	std::mt19937 random( 7 );
+	std::uniform_real_distribution<float> pos( 0, 1 );
+	std::uniform_real_distribution<float> angle( 0, 6.2831853f );
+
+	for(int count : {0, 1, 15, 16, 17, 100})
+	{
+		ObjectArrays objects;
+		objects.resize( count );
+		for(int i = 0; i < count; ++i)
+		{
+			float x = pos(random);
+			objects.set( i, x, pos(random), i % 3 );	// type 2 is never reported
+		}
+		BOOST_CHECK_EQUAL( objects.padded_size() % ObjectArrays::BLOCK, 0u );
+
+		for(int trial = 0; trial < 200; ++trial)
+		{
+			const int RAYS = 9;
+			float sx = pos(random);
+			float sy = pos(random);
+			float dir_x[RAYS], dir_y[RAYS];
+			for(int r = 0; r < RAYS; ++r)
+			{
+				float a = angle(random);
+				dir_x[r] = std::cos(a);
+				dir_y[r] = std::sin(a);
+			}
+
+			float hits[2 * RAYS];
+			castRays( sx, sy, dir_x, dir_y, RAYS, objects, RADIUS, RANGE, hits );
+
+			for(int t = 0; t < 2; ++t)
+			{
+				for(int r = 0; r < RAYS; ++r)
+				{
+					float expected = RANGE;
+					for(int i = 0; i < count; ++i)
+					{
+						if( objects.type(i) == t )
+							expected = std::min( expected, hitTest( sx, sy, dir_x[r], dir_y[r], objects.x(i), objects.y(i), RADIUS ) );
+					}
+					BOOST_REQUIRE_CLOSE( hits[t * RAYS + r], expected, 1e-3 );
+				}
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(shrink)
+{
+	ObjectArrays objects;
+	objects.resize( 3 );
+	objects.set( 0, 0.6, 0.5, 0 );
+	objects.set( 1, 0.7, 0.5, 1 );
+	objects.set( 2, 0.8, 0.5, 0 );
+	objects.resize( 1 );
+
+	float dx = 1, dy = 0;
+	float hits[2];
+	castRays( 0.5, 0.5, &dx, &dy, 1, objects, RADIUS, RANGE, hits );
+	BOOST_CHECK_CLOSE( hits[0], 0.1f - RADIUS, 1e-3 );
+	// removed objects are no longer hit
+	BOOST_CHECK_EQUAL( hits[1], RANGE );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "qlearner/schedule.hpp"
+#include "qlearner/qconfig.hpp"
+#include "qlearner/qlearner.hpp"
+#include "net/network.hpp"
+#include "net/fc_layer.hpp"
+#include "net/solver.hpp"
+#include "net/rmsprop.hpp"
+
+using namespace net;
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(schedules)
+
+BOOST_AUTO_TEST_CASE(shapes)
+{
+	Schedule constant = 0.5;
+	BOOST_CHECK_EQUAL( constant(0), 0.5 );
+	BOOST_CHECK_EQUAL( constant(1000000), 0.5 );
+	BOOST_CHECK( !Schedule() );
+
+	auto linear = Schedule::linear( 1, 0.1, 100 );
+	BOOST_CHECK_EQUAL( linear(0), 1 );
+	BOOST_CHECK_CLOSE( linear(50), 0.55, 1e-9 );
+	BOOST_CHECK_CLOSE( linear(100), 0.1, 1e-9 );
+	BOOST_CHECK_CLOSE( linear(5000), 0.1, 1e-9 );
+
+	auto exponential = Schedule::exponential( 1, 0.5, 0.1 );
+	BOOST_CHECK_CLOSE( exponential(1), 0.5, 1e-9 );
+	BOOST_CHECK_CLOSE( exponential(3), 0.125, 1e-9 );
+	BOOST_CHECK_CLOSE( exponential(4), 0.1, 1e-9 );
+	BOOST_CHECK_THROW( Schedule::exponential( 1, 0 ), std::invalid_argument );
+
+	auto cosine = Schedule::cosine( 1, 0, 100 );
+	BOOST_CHECK_CLOSE( cosine(0), 1, 1e-9 );
+	BOOST_CHECK_CLOSE( cosine(50), 0.5, 1e-9 );
+	BOOST_CHECK_SMALL( cosine(100), 1e-12 );
+	BOOST_CHECK( cosine(25) > 0.5 && cosine(75) < 0.5 );
+}
+
+BOOST_AUTO_TEST_CASE(piecewise)
+{
+	// warmup, then cosine decay, then constant
+	auto schedule = Schedule::piecewise({ {0, Schedule::linear(0, 1, 10)},
+										  {10, Schedule::cosine(1, 0.1, 100)},
+										  {200, 0.01} });
+	BOOST_CHECK_EQUAL( schedule(0), 0 );
+	BOOST_CHECK_CLOSE( schedule(5), 0.5, 1e-9 );
+	BOOST_CHECK_CLOSE( schedule(10), 1, 1e-9 );
+	BOOST_CHECK_CLOSE( schedule(60), 0.55, 1e-9 );
+	BOOST_CHECK_CLOSE( schedule(150), 0.1, 1e-9 );
+	BOOST_CHECK_EQUAL( schedule(200), 0.01 );
+	BOOST_CHECK_EQUAL( schedule(-1), 0.01 );
+
+	BOOST_CHECK_THROW( Schedule::piecewise({}), std::invalid_argument );
+	BOOST_CHECK_THROW( Schedule::piecewise({ {5, 1.0} }), std::invalid_argument );
+	BOOST_CHECK_THROW( Schedule::piecewise({ {0, 1.0}, {0, 2.0} }), std::invalid_argument );
+	BOOST_CHECK_THROW( Schedule::piecewise({ {0, Schedule()} }), std::invalid_argument );
+}
+
+// the default epsilon schedule reproduces the previous linear anneal
+BOOST_AUTO_TEST_CASE(config_epsilon)
+{
+	Config config( 4, 2, 100 );
+	config.init_epsilon_time( 100 ).epsilon_steps( 1000 );
+	BOOST_CHECK_EQUAL( config.getStepEpsilon( 0 ), 1 );
+	BOOST_CHECK_EQUAL( config.getStepEpsilon( 100 ), 1 );
+	BOOST_CHECK_CLOSE( config.getStepEpsilon( 600 ), 0.55, 1e-4 );
+	BOOST_CHECK_CLOSE( config.getStepEpsilon( 1100 ), 0.1, 1e-4 );
+	BOOST_CHECK_CLOSE( config.getStepEpsilon( 100000 ), 0.1, 1e-4 );
+
+	config.init_epsilon_time( 0 );
+	BOOST_CHECK_CLOSE( config.getStepEpsilon( 500 ), 0.55, 1e-4 );
+
+	// a custom schedule cannot be mixed with the anneal parameters, in either order
+	BOOST_CHECK_THROW( config.epsilon( Schedule::exponential( 1, 0.99, 0.05 ) ), std::invalid_argument );
+	Config custom( 4, 2, 100 );
+	custom.epsilon( Schedule::exponential( 1, 0.99, 0.05 ) );
+	BOOST_CHECK_CLOSE( custom.getStepEpsilon( 1 ), 0.99, 1e-4 );
+	BOOST_CHECK_CLOSE( custom.getStepEpsilon( 100000 ), 0.05, 1e-4 );
+	BOOST_CHECK_THROW( custom.epsilon_steps( 1000 ), std::invalid_argument );
+	BOOST_CHECK_THROW( custom.init_epsilon_time( 0 ), std::invalid_argument );
+	BOOST_CHECK_CLOSE( custom.getStepEpsilon( 100000 ), 0.05, 1e-4 );
+
+	// an empty schedule could not be evaluated in the first step
+	BOOST_CHECK_THROW( Config( 4, 2, 100 ).epsilon( Schedule() ), std::invalid_argument );
+	BOOST_CHECK_THROW( custom.epsilon( Schedule() ), std::invalid_argument );
+	BOOST_CHECK_CLOSE( custom.getStepEpsilon( 100000 ), 0.05, 1e-4 );
+}
+
+BOOST_AUTO_TEST_CASE(config_target_tau)
+{
+	Config config( 4, 2, 100 );
+	BOOST_CHECK_NO_THROW( config.target_tau( 0 ).target_tau( 1 ).target_tau( Schedule::linear( 0.1, 0, 100 ) ) );
+	BOOST_CHECK_THROW( config.target_tau( -0.01 ), std::invalid_argument );
+	BOOST_CHECK_THROW( config.target_tau( 1.5 ), std::invalid_argument );
+	BOOST_CHECK_THROW( config.target_tau( Schedule() ), std::invalid_argument );
+
+	// values that leave the range later are rejected by the learner when they are reached
+	Network network;
+	network << FcLayer( Matrix::Random(2, 4) );
+	QLearner learner( Config( 4, 2, 100 ).init_memory_size( 2 ).batch_size( 2 )
+										 .target_tau( Schedule::linear( 0.5, -0.5, 10 ) ), std::move(network) );
+	Solver solver( std::make_unique<RMSProp>(0.9, 0.001, 0.01) );
+	Vector state = Vector::Random(4);
+	int steps = 0;
+	BOOST_CHECK_THROW( for(; steps < 100; ++steps) learner.learn_step( state, 0.f, false, solver ), std::invalid_argument );
+	BOOST_CHECK( steps > 5 && steps < 20 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
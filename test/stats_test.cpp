@@ -0,0 +1,142 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "qlearner/stats.h"
+
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(stats)
+
+BOOST_AUTO_TEST_CASE(rolling_window)
+{
+	RollingWindow window( 50 );
+	std::vector<float> values;
+	std::mt19937 random( 3 );
+	std::normal_distribution<float> dist( 2, 3 );
+	for(int i = 0; i < 1000; ++i)
+	{
+		values.push_back( dist( random ) );
+		window.push( values.back() );
+
+		std::size_t n = std::min<std::size_t>( values.size(), 50 );
+		double sum = 0, squares = 0;
+		for(std::size_t j = values.size() - n; j < values.size(); ++j)
+		{
+			sum += values[j];
+			squares += values[j] * values[j];
+		}
+		double mean = sum / n;
+		BOOST_REQUIRE_EQUAL( window.size(), n );
+		BOOST_REQUIRE_CLOSE( window.mean(), mean, 1e-3 );
+		double variance = squares / n - mean * mean;
+		BOOST_REQUIRE_SMALL( window.variance() - variance, 1e-4 * (1 + variance) );
+	}
+}
+
+// a large value that leaves the window must not leave rounding errors behind
+BOOST_AUTO_TEST_CASE(rolling_window_cancellation)
+{
+	RollingWindow window( 4 );
+	window.push( 1e9f );
+	for(int i = 0; i < 7; ++i)
+		window.push( 0.25f );
+	BOOST_CHECK_EQUAL( window.mean(), 0.25f );
+	BOOST_CHECK_EQUAL( window.variance(), 0.f );
+
+	// also if the large value was pushed in the middle of a round
+	window.push( 1e9f );
+	for(int i = 0; i < 7; ++i)
+		window.push( 0.5f );
+	BOOST_CHECK_EQUAL( window.mean(), 0.5f );
+	BOOST_CHECK_EQUAL( window.variance(), 0.f );
+}
+
+BOOST_AUTO_TEST_CASE(quantile_sketch)
+{
+	QuantileSketch sketch;
+	std::vector<float> values;
+	std::mt19937 random( 4 );
+	std::lognormal_distribution<float> dist( 0, 2 );
+	for(int i = 0; i < 10001; ++i)
+	{
+		// a third of the values are negative, and some are zero
+		float v = i % 3 == 0 ? -dist( random ) : dist( random );
+		if( i % 10 == 0 )
+			v = 0;
+		values.push_back( v );
+		sketch.add( v );
+	}
+	std::sort( values.begin(), values.end() );
+	BOOST_CHECK_EQUAL( sketch.count(), values.size() );
+	for(double q : {0.0, 0.05, 0.3, 0.5, 0.9, 0.99, 1.0})
+	{
+		float exact = values[q * (values.size() - 1)];
+		float approx = sketch.quantile( q );
+		BOOST_CHECK_SMALL( approx - exact, std::abs( exact ) * float(QuantileSketch::RELATIVE_ACCURACY) + 1e-6f );
+	}
+
+	sketch.reset();
+	BOOST_CHECK_EQUAL( sketch.count(), 0u );
+	BOOST_CHECK_EQUAL( sketch.quantile( 0.5 ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(episodes)
+{
+	Stats stats( 100, 2, 5 );
+	// episodes of length 5 with returns 1, 2, 3
+	for(int e = 1; e <= 3; ++e)
+	{
+		for(int s = 0; s < 5; ++s)
+			stats.record( s == 4 ? e : 0, 0.5, s == 4 );
+	}
+	StatsSnapshot snapshot = stats.snapshot();
+	BOOST_CHECK_EQUAL( snapshot.steps, 15u );
+	BOOST_CHECK_EQUAL( snapshot.episodes, 3u );
+	BOOST_CHECK_EQUAL( snapshot.last_return, 3 );
+	BOOST_CHECK_CLOSE( snapshot.return_mean, 2.5, 1e-4 );
+	BOOST_CHECK_CLOSE( snapshot.qval_mean, 0.5, 1e-4 );
+	BOOST_CHECK_CLOSE( snapshot.reward_mean, 6.0 / 15, 1e-4 );
+	BOOST_CHECK_EQUAL( snapshot.reward_quantiles[0], 0 );
+}
+
+// snapshots that are read while the learner publishes are never torn
+BOOST_AUTO_TEST_CASE(concurrent_snapshots)
+{
+	const int EPISODE = 4;
+	Stats stats( 100, 10, 1 );
+	std::atomic<bool> done( false );
+	std::atomic<bool> torn( false );
+	std::atomic<int> checked( 0 );
+	std::thread reader( [&]()
+	{
+		while( !done )
+		{
+			StatsSnapshot s = stats.snapshot();
+			if( s.steps / EPISODE != s.episodes || s.last_return != (s.episodes ? s.episodes : 0) )
+			{
+				torn = true;
+				return;
+			}
+			++checked;
+		}
+	} );
+
+	for(int step = 1; step <= 200000; ++step)
+	{
+		bool terminal = step % EPISODE == 0;
+		// the return of episode e is e
+		stats.record( terminal ? step / EPISODE : 0, 0, terminal );
+	}
+	done = true;
+	reader.join();
+	BOOST_CHECK( !torn );
+	BOOST_CHECK( checked > 0 );
+	BOOST_CHECK_EQUAL( stats.snapshot().episodes, 200000u / EPISODE );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
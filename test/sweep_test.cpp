@@ -0,0 +1,130 @@
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "qlearner/sweep.hpp"
+#include "net/network.hpp"
+#include "test_games.hpp"
+
+using namespace qlearn;
+
+BOOST_AUTO_TEST_SUITE(sweeps)
+
+BOOST_AUTO_TEST_CASE(search_space)
+{
+	SearchSpace space;
+	space.choice( "learner.batch_size", {8, 16, 32} ).choice( "network[0].size", std::vector<std::string>{"4", "8"} );
+	auto grid = space.grid();
+	BOOST_REQUIRE_EQUAL( grid.size(), 6u );
+	std::set<std::string> combinations;
+	for(const auto& trial : grid)
+	{
+		BOOST_REQUIRE_EQUAL( trial.values.size(), 2u );
+		combinations.insert( trial.values[0].second + "/" + trial.values[1].second );
+	}
+	BOOST_CHECK_EQUAL( combinations.size(), 6u );
+	BOOST_CHECK_EQUAL( grid[1].values[1].second, "8" );
+
+	// trials can be applied to an experiment
+	auto experiment = base().with( grid[5].values );
+	BOOST_CHECK_EQUAL( experiment.config().batch_size(), 32u );
+	BOOST_CHECK_EQUAL( experiment.makeNetwork( 0 ).getLayers()[0]->getOutputSize(), 8u );
+	BOOST_CHECK_THROW( base().with({ {"network[7].size", "3"} }), std::invalid_argument );
+
+	space.log_uniform( "optimizer.rate", 1e-5, 1e-3 ).uniform( "learner.update_interval", 10, 20, true );
+	BOOST_CHECK_THROW( space.grid(), std::logic_error );
+	auto samples = space.sample( 50, 3 );
+	BOOST_REQUIRE_EQUAL( samples.size(), 50u );
+	for(const auto& trial : samples)
+	{
+		double rate = std::stod( trial.values[2].second );
+		BOOST_CHECK( rate >= 1e-5 && rate <= 1e-3 );
+		double interval = std::stod( trial.values[3].second );
+		BOOST_CHECK( interval >= 10 && interval <= 20 && interval == (int)interval );
+	}
+	BOOST_CHECK( space.sample( 50, 3 )[7].values == samples[7].values );
+}
+
+BOOST_AUTO_TEST_CASE(early_stopping)
+{
+	SearchSpace space;
+	space.choice( "learner.discount_factor", {0.9, 0.8, 0.7, 0.6, 0.1, 0.2, 2.0} );
+	auto trials = space.grid();
+
+	SweepOptions options;
+	options.steps = 600;
+	options.eval_interval = 200;
+	options.min_trials = 4;
+	options.workers = 1;
+	SweepRunner runner( base(), make_game, options );
+	auto results = runner.run( trials );
+	BOOST_REQUIRE_EQUAL( results.size(), trials.size() );
+
+	// the first three trials set the bar. The fourth one is the first that can be stopped, and is
+	// below the median.
+	for(std::size_t i = 0; i < 3; ++i)
+	{
+		BOOST_CHECK( !results[i].stopped );
+		BOOST_CHECK_EQUAL( results[i].steps, 600u );
+		BOOST_CHECK_CLOSE( results[i].reward, std::stod( results[i].trial.values[0].second ), 1e-3 );
+	}
+	BOOST_CHECK( results[3].stopped );
+	BOOST_CHECK( results[4].stopped );
+	BOOST_CHECK( results[5].stopped );
+	BOOST_CHECK_EQUAL( results[4].steps, 200u );
+	// a discount factor above 1 is rejected by the experiment
+	BOOST_CHECK( !results[6].error.empty() );
+
+	std::ostringstream table;
+	SweepRunner::writeTable( table, space.getPaths(), results );
+	std::string line;
+	std::istringstream lines( table.str() );
+	std::getline( lines, line );
+	BOOST_CHECK_EQUAL( line, "trial,learner.discount_factor,steps,reward,best_reward,status,seconds,error" );
+	std::getline( lines, line );
+	BOOST_CHECK_EQUAL( line.compare( 0, 12, "0,0.9,600,0." ), 0 );
+	std::size_t rows = 1;
+	while( std::getline( lines, line ) )
+		++rows;
+	BOOST_CHECK_EQUAL( rows, trials.size() );
+}
+
+// values with separators or quotes are quoted, so they do not break the table
+BOOST_AUTO_TEST_CASE(table_quoting)
+{
+	TrialResult result;
+	result.trial.values = { {"game", "a,b"}, {"name", "say \"hi\""} };
+	std::ostringstream table;
+	SweepRunner::writeTable( table, {"game", "name"}, {result} );
+	std::string line;
+	std::istringstream lines( table.str() );
+	std::getline( lines, line );
+	std::getline( lines, line );
+	const std::string expected = "0,\"a,b\",\"say \"\"hi\"\"\",0,";
+	BOOST_CHECK_EQUAL( line.substr( 0, expected.size() ), expected );
+}
+
+BOOST_AUTO_TEST_CASE(parallel)
+{
+	SearchSpace space;
+	space.choice( "learner.discount_factor", {0.9, 0.8, 0.7, 0.6} ).choice( "learner.seed", {1, 2} );
+	SweepOptions options;
+	options.steps = 300;
+	options.eval_interval = 100;
+	options.stop_quantile = 0;
+	options.workers = 3;
+	SweepRunner runner( base(), make_game, options );
+	auto results = runner.run( space.grid() );
+	BOOST_REQUIRE_EQUAL( results.size(), 8u );
+	for(std::size_t i = 0; i < results.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( results[i].trial.id, i );
+		BOOST_CHECK( results[i].error.empty() );
+		BOOST_CHECK_EQUAL( results[i].steps, 300u );
+		BOOST_CHECK_CLOSE( results[i].reward, std::stod( results[i].trial.values[0].second ), 1e-3 );
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "qlearner/experiment.hpp"
+#include "games/game.h"
+
+// a game whose reward per step is fixed, so that the ranking of learners trained on it is known
+class ConstantReward : public Game
+{
+public:
+	explicit ConstantReward( float reward ) : mReward( reward ) { }
+	int getNumInputs() const override { return 2; }
+	void getCurrentState( Vector& target ) const override { target = Vector::Constant( 4, mReward ); }
+	bool isFinished() const override { return false; }
+	void restart() override { }
+	float step( int ) override { return mReward; }
+private:
+	float mReward;
+};
+
+// game factory for sweeps and populations: the discount factor of the experiment doubles as the reward
+inline std::unique_ptr<Game> make_game( const qlearn::Experiment& experiment, std::uint64_t )
+{
+	return std::make_unique<ConstantReward>( experiment.config().gamma() );
+}
+
+// a small learner that fits ConstantReward
+inline qlearn::Experiment base()
+{
+	return qlearn::Experiment::fromString( R"({ "inputs": 4, "actions": 2,
+												"learner": { "memory": 500, "batch_size": 4, "init_memory_size": 50 },
+												"network": [ { "type": "fc", "size": 8 }, "tanh", { "type": "fc", "size": 2 } ],
+												"optimizer": { "type": "rmsprop", "rate": 0.01 } })" );
+}
@@ -0,0 +1,45 @@
+#include "affinity.hpp"
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace util
+{
+	bool pin_current_thread( const std::vector<int>& cores )
+	{
+#ifdef __linux__
+		if( cores.empty() )
+			return false;
+		cpu_set_t set;
+		CPU_ZERO( &set );
+		for(int core : cores)
+		{
+			if( core < 0 || core >= CPU_SETSIZE )
+				return false;
+			CPU_SET( core, &set );
+		}
+		return pthread_setaffinity_np( pthread_self(), sizeof(set), &set ) == 0;
+#else
+		return false;
+#endif
+	}
+	
+	std::vector<std::vector<int>> split_cores( std::vector<int> cores, std::size_t group_size )
+	{
+		if( cores.empty() )
+		{
+			for(unsigned c = 0; c < std::max( 1u, std::thread::hardware_concurrency() ); ++c)
+				cores.push_back( c );
+		}
+		group_size = std::max<std::size_t>( group_size, 1 );
+		
+		std::vector<std::vector<int>> groups;
+		for(std::size_t i = 0; i < cores.size(); i += group_size)
+			groups.emplace_back( cores.begin() + i, cores.begin() + std::min( i + group_size, cores.size() ) );
+		return groups;
+	}
+}
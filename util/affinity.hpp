@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+namespace util
+{
+	// restricts the calling thread to the given cores. Returns false if that is not possible, e.g.
+	// because the platform does not support it or a core does not exist.
+	bool pin_current_thread( const std::vector<int>& cores );
+	
+	// splits cores into groups of group_size, e.g. for running independent jobs on separate cores.
+	// The last group is smaller if the cores do not divide evenly. An empty core list stands for all
+	// cores of the machine.
+	std::vector<std::vector<int>> split_cores( std::vector<int> cores, std::size_t group_size );
+}
@@ -0,0 +1,82 @@
+#include "alloc_count.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local std::size_t allocations = 0;
+}
+
+namespace util
+{
+	std::size_t allocation_count()
+	{
+		return allocations;
+	}
+}
+
+#ifdef __GLIBC__
+// interpose the malloc family. operator new and Eigen both end up here.
+extern "C"
+{
+	void* __libc_malloc( std::size_t size );
+	void* __libc_calloc( std::size_t count, std::size_t size );
+	void* __libc_realloc( void* ptr, std::size_t size );
+	void* __libc_memalign( std::size_t alignment, std::size_t size );
+
+	void* malloc( std::size_t size )
+	{
+		++allocations;
+		return __libc_malloc( size );
+	}
+
+	void* calloc( std::size_t count, std::size_t size )
+	{
+		++allocations;
+		return __libc_calloc( count, size );
+	}
+
+	void* realloc( void* ptr, std::size_t size )
+	{
+		++allocations;
+		return __libc_realloc( ptr, size );
+	}
+
+	void* memalign( std::size_t alignment, std::size_t size )
+	{
+		++allocations;
+		return __libc_memalign( alignment, size );
+	}
+
+	int posix_memalign( void** ptr, std::size_t alignment, std::size_t size )
+	{
+		++allocations;
+		*ptr = __libc_memalign( alignment, size );
+		return *ptr ? 0 : ENOMEM;
+	}
+}
+#else
+void* operator new( std::size_t size )
+{
+	++allocations;
+	if( void* ptr = std::malloc( size ) )
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size )
+{
+	return operator new( size );
+}
+
+void operator delete( void* ptr ) noexcept
+{
+	std::free( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept
+{
+	std::free( ptr );
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+namespace util
+{
+	// number of heap allocations made by the calling thread so far. This counts calls to malloc,
+	// which catches both operator new and Eigen's aligned allocations on glibc, and falls back to
+	// counting operator new elsewhere.
+	// alloc_count.cpp replaces the allocation functions of the whole program, so it should only be
+	// linked into benchmarks and tests.
+	std::size_t allocation_count();
+
+	// counts the allocations made in its lifetime
+	class AllocationScope
+	{
+	public:
+		AllocationScope() : mStart( allocation_count() ) {}
+		std::size_t count() const { return allocation_count() - mStart; }
+	private:
+		std::size_t mStart;
+	};
+}
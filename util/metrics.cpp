@@ -0,0 +1,128 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+#include <stdexcept>
+
+namespace metrics
+{
+	Histogram::Histogram( std::vector<double> bounds ) : mBounds( std::move(bounds) ),
+		mCounts( new std::atomic<std::uint64_t>[mBounds.size() + 1] )
+	{
+		assert( std::is_sorted( mBounds.begin(), mBounds.end() ) );
+		for(std::size_t i = 0; i <= mBounds.size(); ++i)
+			mCounts[i].store( 0, std::memory_order_relaxed );
+	}
+
+	void Histogram::observe( double value )
+	{
+		std::size_t bucket = std::lower_bound( mBounds.begin(), mBounds.end(), value ) - mBounds.begin();
+		mCounts[bucket].fetch_add( 1, std::memory_order_relaxed );
+		double sum = mSum.load( std::memory_order_relaxed );
+		while( !mSum.compare_exchange_weak( sum, sum + value, std::memory_order_relaxed ) )
+		{
+		}
+	}
+
+	std::uint64_t Histogram::count() const
+	{
+		std::uint64_t total = 0;
+		for(std::size_t i = 0; i <= mBounds.size(); ++i)
+			total += count( i );
+		return total;
+	}
+
+	std::vector<double> exponentialBuckets( double start, double factor, std::size_t count )
+	{
+		std::vector<double> bounds;
+		for(std::size_t i = 0; i < count; ++i, start *= factor)
+			bounds.push_back( start );
+		return bounds;
+	}
+
+	// ---------------------------------------------------------------------------------------------
+	struct Registry::Entry
+	{
+		std::string name;
+		std::string help;
+		std::unique_ptr<Counter> counter;
+		std::unique_ptr<Gauge> gauge;
+		std::unique_ptr<Histogram> histogram;
+	};
+
+	Registry::Registry() = default;
+	Registry::~Registry() = default;
+
+	Registry::Entry& Registry::add( const std::string& name, const std::string& help )
+	{
+		for(const auto& entry : mEntries)
+		{
+			if( entry->name == name )
+				throw std::invalid_argument("metric " + name + " is already registered");
+		}
+		mEntries.push_back( std::make_unique<Entry>() );
+		mEntries.back()->name = name;
+		mEntries.back()->help = help;
+		return *mEntries.back();
+	}
+
+	Counter& Registry::counter( const std::string& name, const std::string& help )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto& entry = add( name, help );
+		entry.counter = std::make_unique<Counter>();
+		return *entry.counter;
+	}
+
+	Gauge& Registry::gauge( const std::string& name, const std::string& help )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto& entry = add( name, help );
+		entry.gauge = std::make_unique<Gauge>();
+		return *entry.gauge;
+	}
+
+	Histogram& Registry::histogram( const std::string& name, const std::string& help, std::vector<double> bounds )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto& entry = add( name, help );
+		entry.histogram = std::make_unique<Histogram>( std::move(bounds) );
+		return *entry.histogram;
+	}
+
+	void Registry::writePrometheus( std::ostream& out ) const
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto precision = out.precision( 12 );
+		for(const auto& entry : mEntries)
+		{
+			const std::string& name = entry->name;
+			out << "# HELP " << name << " " << entry->help << "\n";
+			if( entry->counter )
+			{
+				out << "# TYPE " << name << " counter\n";
+				out << name << " " << entry->counter->value() << "\n";
+			} else if( entry->gauge )
+			{
+				out << "# TYPE " << name << " gauge\n";
+				out << name << " " << entry->gauge->value() << "\n";
+			} else
+			{
+				// buckets are cumulative in the exposition format
+				const Histogram& h = *entry->histogram;
+				out << "# TYPE " << name << " histogram\n";
+				std::uint64_t cumulative = 0;
+				for(std::size_t i = 0; i < h.bounds().size(); ++i)
+				{
+					cumulative += h.count( i );
+					out << name << "_bucket{le=\"" << h.bounds()[i] << "\"} " << cumulative << "\n";
+				}
+				cumulative += h.count( h.bounds().size() );
+				out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+				out << name << "_sum " << h.sum() << "\n";
+				out << name << "_count " << cumulative << "\n";
+			}
+		}
+		out.precision( precision );
+	}
+}
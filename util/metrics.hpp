@@ -0,0 +1,88 @@
+#pragma once
+
+/*! \file metrics.hpp
+	\brief Counters, gauges and histograms that can be exported in the Prometheus text format.
+	\details Metrics are registered once in a Registry, which owns them and keeps their addresses
+			stable. Updating a metric is a relaxed atomic operation, so the learner can update them on
+			every step, while another thread (e.g. a MetricsServer) exports them.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace metrics
+{
+	// monotonically increasing count, e.g. of environment steps
+	class Counter
+	{
+	public:
+		void add( std::uint64_t n = 1 ) { mValue.fetch_add( n, std::memory_order_relaxed ); }
+		std::uint64_t value() const { return mValue.load( std::memory_order_relaxed ); }
+	private:
+		std::atomic<std::uint64_t> mValue{0};
+	};
+
+	// value that can go up and down, e.g. the fill level of the replay memory
+	class Gauge
+	{
+	public:
+		void set( double value ) { mValue.store( value, std::memory_order_relaxed ); }
+		double value() const { return mValue.load( std::memory_order_relaxed ); }
+	private:
+		std::atomic<double> mValue{0};
+	};
+
+	// distribution of observed values in buckets with fixed upper bounds, e.g. of latencies
+	class Histogram
+	{
+	public:
+		// bounds are the inclusive upper bounds of the buckets, in ascending order. An additional
+		// bucket collects all larger values.
+		explicit Histogram( std::vector<double> bounds );
+
+		void observe( double value );
+
+		const std::vector<double>& bounds() const { return mBounds; }
+		// number of observations in bucket i, not cumulative
+		std::uint64_t count( std::size_t bucket ) const { return mCounts[bucket].load( std::memory_order_relaxed ); }
+		std::uint64_t count() const;
+		double sum() const { return mSum.load( std::memory_order_relaxed ); }
+	private:
+		std::vector<double> mBounds;
+		std::unique_ptr<std::atomic<std::uint64_t>[]> mCounts;
+		std::atomic<double> mSum{0};
+	};
+
+	// count bounds start, start * factor, start * factor^2, ...
+	std::vector<double> exponentialBuckets( double start, double factor, std::size_t count );
+
+	/*! \class Registry
+		\brief Owns named metrics and writes them in the Prometheus text exposition format.
+		\details Registering is synchronized, but should happen before the hot loop starts. Names have
+				to be valid Prometheus metric names; registering a name twice throws std::invalid_argument.
+	*/
+	class Registry
+	{
+	public:
+		Registry();
+		~Registry();
+
+		Counter& counter( const std::string& name, const std::string& help );
+		Gauge& gauge( const std::string& name, const std::string& help );
+		Histogram& histogram( const std::string& name, const std::string& help, std::vector<double> bounds );
+
+		void writePrometheus( std::ostream& out ) const;
+
+	private:
+		struct Entry;
+		Entry& add( const std::string& name, const std::string& help );
+
+		mutable std::mutex mMutex;
+		std::vector<std::unique_ptr<Entry>> mEntries;
+	};
+}
@@ -0,0 +1,157 @@
+#include "metrics_server.hpp"
+#include "metrics.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace metrics
+{
+namespace
+{
+	// how often the server thread checks whether it should stop
+	const int POLL_MS = 100;
+	// a client that does not send its request in time is dropped
+	const int REQUEST_TIMEOUT_MS = 1000;
+
+	[[noreturn]] void fail( int fd, const std::string& what )
+	{
+		std::string message = what + ": " + std::strerror(errno);
+		if( fd >= 0 )
+			::close( fd );
+		throw std::runtime_error( message );
+	}
+
+	void sendAll( int fd, const std::string& data )
+	{
+		std::size_t sent = 0;
+		while( sent < data.size() )
+		{
+			ssize_t n = ::send( fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL );
+			if( n < 0 && errno == EINTR )
+				continue;
+			if( n <= 0 )
+				return;
+			sent += n;
+		}
+	}
+}
+
+MetricsServer::MetricsServer( const Registry& registry, int port ) : mRegistry( registry )
+{
+	mSocket = ::socket( AF_INET, SOCK_STREAM, 0 );
+	if( mSocket < 0 )
+		fail( -1, "could not create metrics socket" );
+	int reuse = 1;
+	::setsockopt( mSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse) );
+
+	sockaddr_in address;
+	std::memset( &address, 0, sizeof(address) );
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	address.sin_port = htons( port );
+	if( ::bind( mSocket, (sockaddr*)&address, sizeof(address) ) != 0 )
+		fail( mSocket, "could not bind metrics port " + std::to_string(port) );
+	if( ::listen( mSocket, 8 ) != 0 )
+		fail( mSocket, "could not listen on metrics port" );
+
+	socklen_t length = sizeof(address);
+	::getsockname( mSocket, (sockaddr*)&address, &length );
+	mPort = ntohs( address.sin_port );
+	mThread = std::thread( &MetricsServer::run, this );
+}
+
+MetricsServer::MetricsServer( const Registry& registry, const std::string& socket_path ) :
+	mRegistry( registry ), mSocketPath( socket_path )
+{
+	sockaddr_un address;
+	std::memset( &address, 0, sizeof(address) );
+	if( socket_path.size() >= sizeof(address.sun_path) )
+		throw std::runtime_error("metrics socket path too long: " + socket_path);
+	address.sun_family = AF_UNIX;
+	std::strcpy( address.sun_path, socket_path.c_str() );
+
+	mSocket = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( mSocket < 0 )
+		fail( -1, "could not create metrics socket" );
+	::unlink( socket_path.c_str() );
+	if( ::bind( mSocket, (sockaddr*)&address, sizeof(address) ) != 0 )
+		fail( mSocket, "could not bind metrics socket " + socket_path );
+	if( ::listen( mSocket, 8 ) != 0 )
+		fail( mSocket, "could not listen on metrics socket " + socket_path );
+	mThread = std::thread( &MetricsServer::run, this );
+}
+
+std::unique_ptr<MetricsServer> MetricsServer::fromEnvironment( const Registry& registry )
+{
+	if( const char* port = std::getenv( "DQN_METRICS_PORT" ) )
+		return std::make_unique<MetricsServer>( registry, std::atoi( port ) );
+	if( const char* path = std::getenv( "DQN_METRICS_SOCKET" ) )
+		return std::make_unique<MetricsServer>( registry, std::string( path ) );
+	return nullptr;
+}
+
+MetricsServer::~MetricsServer()
+{
+	mStop = true;
+	mThread.join();
+	::close( mSocket );
+	if( !mSocketPath.empty() )
+		::unlink( mSocketPath.c_str() );
+}
+
+void MetricsServer::run()
+{
+	while( !mStop )
+	{
+		pollfd listener{ mSocket, POLLIN, 0 };
+		if( ::poll( &listener, 1, POLL_MS ) <= 0 )
+			continue;
+		int connection = ::accept( mSocket, nullptr, nullptr );
+		if( connection < 0 )
+			continue;
+		respond( connection );
+		::close( connection );
+	}
+}
+
+void MetricsServer::respond( int connection ) const
+{
+	// read until the end of the request header
+	std::string request;
+	char buffer[1024];
+	while( request.find( "\r\n\r\n" ) == std::string::npos && request.size() < 8192 )
+	{
+		pollfd client{ connection, POLLIN, 0 };
+		if( ::poll( &client, 1, REQUEST_TIMEOUT_MS ) <= 0 )
+			return;
+		ssize_t n = ::recv( connection, buffer, sizeof(buffer), 0 );
+		if( n <= 0 )
+			return;
+		request.append( buffer, n );
+	}
+
+	std::string status = "200 OK";
+	std::ostringstream body;
+	if( request.compare( 0, 4, "GET " ) != 0 )
+		status = "405 Method Not Allowed";
+	else
+		mRegistry.writePrometheus( body );
+
+	std::string content = body.str();
+	std::ostringstream response;
+	response << "HTTP/1.0 " << status << "\r\n"
+			 << "Content-Type: text/plain; version=0.0.4\r\n"
+			 << "Content-Length: " << content.size() << "\r\n"
+			 << "Connection: close\r\n\r\n"
+			 << content;
+	sendAll( connection, response.str() );
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace metrics
+{
+	class Registry;
+
+	/*! \class MetricsServer
+		\brief Minimal HTTP endpoint that serves a Registry in the Prometheus text format.
+		\details Listens either on a TCP port of the loopback interface, or on a unix domain socket
+				(e.g. for curl --unix-socket). Every request is answered with the current metrics, on
+				the server's own thread, so scraping never touches the thread that updates the metrics.
+				Requests are handled one at a time, which is sufficient for a local scraper.
+				The registry has to outlive the server.
+	*/
+	class MetricsServer
+	{
+	public:
+		// listens on 127.0.0.1:port. Port 0 picks a free port, see getPort().
+		// Throws std::runtime_error if the socket cannot be opened.
+		MetricsServer( const Registry& registry, int port );
+		// listens on a unix domain socket at path. An existing socket file is replaced.
+		MetricsServer( const Registry& registry, const std::string& socket_path );
+		// stops the server thread
+		~MetricsServer();
+
+		MetricsServer( const MetricsServer& ) = delete;
+		MetricsServer& operator=( const MetricsServer& ) = delete;
+
+		// starts a server if DQN_METRICS_PORT or DQN_METRICS_SOCKET is set, otherwise returns nullptr.
+		static std::unique_ptr<MetricsServer> fromEnvironment( const Registry& registry );
+
+		// the TCP port, or 0 for a unix domain socket
+		int getPort() const { return mPort; }
+
+	private:
+		void run();
+		void respond( int connection ) const;
+
+		const Registry& mRegistry;
+		int mSocket = -1;
+		int mPort = 0;
+		std::string mSocketPath;
+		std::atomic<bool> mStop{false};
+		std::thread mThread;
+	};
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/*! \file random.hpp
+	\brief Fast, seedable random numbers.
+	\details Random is a xoshiro256** generator. Every generator is identified by a seed and a stream
+			index, and split() derives independent generators for threads or environments from it,
+			so that a run is reproducible for a given seed, no matter how its work is distributed.
+			The batched games use the stateless counter_random() instead, which gives the n'th number
+			of a stream directly.
+*/
+namespace util
+{
+	// splitmix64 finalizer, a bijective mixing function
+	inline std::uint64_t mix64( std::uint64_t x )
+	{
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+
+	// key of the random stream with the given index
+	inline std::uint64_t stream_key( std::uint64_t seed, std::uint64_t stream )
+	{
+		return mix64( mix64( seed ) + stream );
+	}
+
+	// the counter'th random number of the stream with the given key
+	inline std::uint64_t counter_random( std::uint64_t key, std::uint64_t counter )
+	{
+		return mix64( key ^ mix64( counter ) );
+	}
+
+	/*! \class Random
+		\brief xoshiro256** generator with cheap helpers for the common distributions.
+		\details Satisfies the UniformRandomBitGenerator requirements, so it can also be used with
+				the distributions of <random>.
+	*/
+	class Random
+	{
+	public:
+		using result_type = std::uint64_t;
+
+		explicit Random( std::uint64_t seed = 0, std::uint64_t stream = 0 );
+
+		// independent generator for the given stream, e.g. a thread index
+		Random split( std::uint64_t stream ) const { return Random( mKey, stream ); }
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+		result_type operator()();
+
+		// uniform in [0, 1)
+		float uniform();
+		// uniform in [0, n), n > 0. The bias is below n / 2^32.
+		std::uint32_t uniform_int( std::uint32_t n );
+		// true with probability p
+		bool bernoulli( float p ) { return uniform() < p; }
+
+	private:
+		std::uint64_t mKey;
+		std::uint64_t mState[4];
+	};
+
+	inline Random::Random( std::uint64_t seed, std::uint64_t stream ) : mKey( stream_key( seed, stream ) )
+	{
+		// the state must not be all zero, which the bijective mix guarantees for consecutive inputs
+		for(int i = 0; i < 4; ++i)
+			mState[i] = mix64( mKey + i );
+	}
+
+	inline Random::result_type Random::operator()()
+	{
+		auto rotl = []( std::uint64_t x, int k ) { return (x << k) | (x >> (64 - k)); };
+		std::uint64_t result = rotl( mState[1] * 5, 7 ) * 9;
+		std::uint64_t t = mState[1] << 17;
+		mState[2] ^= mState[0];
+		mState[3] ^= mState[1];
+		mState[1] ^= mState[2];
+		mState[0] ^= mState[3];
+		mState[2] ^= t;
+		mState[3] = rotl( mState[3], 45 );
+		return result;
+	}
+
+	inline float Random::uniform()
+	{
+		// the upper 24 bits fill the mantissa exactly
+		return ((*this)() >> 40) * (1.f / (1 << 24));
+	}
+
+	inline std::uint32_t Random::uniform_int( std::uint32_t n )
+	{
+		// multiply-shift instead of a division
+		return std::uint32_t( (((*this)() >> 32) * n) >> 32 );
+	}
+}
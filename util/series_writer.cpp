@@ -0,0 +1,129 @@
+#include "series_writer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace metrics
+{
+namespace
+{
+	// how often the writer thread drains the buffer
+	const std::chrono::milliseconds WRITE_INTERVAL( 200 );
+	const char MAGIC[] = "DQNSERIES";
+}
+
+SeriesWriter::SeriesWriter( const std::string& path, std::vector<std::string> columns, Format format, std::size_t capacity ) :
+	mColumns( std::move(columns) ), mWidth( mColumns.size() + 1 ), mFormat( format ),
+	mStart( std::chrono::steady_clock::now() ), mRows( capacity * mWidth ), mCapacity( capacity )
+{
+	mFile = std::fopen( path.c_str(), format == Format::CSV ? "w" : "wb" );
+	if( !mFile )
+		throw std::runtime_error("could not open " + path + ": " + std::strerror(errno));
+	writeHeader();
+	mThread = std::thread( &SeriesWriter::run, this );
+}
+
+SeriesWriter::~SeriesWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStop = true;
+	}
+	mCondition.notify_all();
+	mThread.join();
+	std::fclose( mFile );
+}
+
+void SeriesWriter::writeHeader()
+{
+	if( mFormat == Format::CSV )
+	{
+		std::fputs( "time", mFile );
+		for(const auto& column : mColumns)
+			std::fprintf( mFile, ",%s", column.c_str() );
+		std::fputc( '\n', mFile );
+	} else
+	{
+		std::fwrite( MAGIC, 1, sizeof(MAGIC) - 1, mFile );
+		std::uint32_t count = mWidth;
+		std::fwrite( &count, sizeof(count), 1, mFile );
+		std::fwrite( "time", 1, 5, mFile );
+		for(const auto& column : mColumns)
+			std::fwrite( column.c_str(), 1, column.size() + 1, mFile );
+	}
+}
+
+bool SeriesWriter::record( const double* values )
+{
+	std::size_t head = mHead.load( std::memory_order_relaxed );
+	if( head - mTail.load( std::memory_order_acquire ) == mCapacity )
+	{
+		mDropped.fetch_add( 1, std::memory_order_relaxed );
+		return false;
+	}
+
+	double* row = &mRows[(head % mCapacity) * mWidth];
+	row[0] = std::chrono::duration<double>( std::chrono::steady_clock::now() - mStart ).count();
+	std::copy( values, values + mColumns.size(), row + 1 );
+	mHead.store( head + 1, std::memory_order_release );
+	return true;
+}
+
+bool SeriesWriter::drain()
+{
+	std::size_t head = mHead.load( std::memory_order_acquire );
+	std::size_t tail = mTail.load( std::memory_order_relaxed );
+	if( head == tail )
+		return false;
+
+	for(; tail != head; ++tail)
+	{
+		const double* row = &mRows[(tail % mCapacity) * mWidth];
+		if( mFormat == Format::CSV )
+		{
+			for(std::size_t i = 0; i < mWidth; ++i)
+				std::fprintf( mFile, i == 0 ? "%.6f" : ",%.9g", row[i] );
+			std::fputc( '\n', mFile );
+		} else
+		{
+			std::fwrite( row, sizeof(double), mWidth, mFile );
+		}
+		// the slot can be reused as soon as the row has been copied into the file buffer
+		mTail.store( tail + 1, std::memory_order_release );
+	}
+	return true;
+}
+
+void SeriesWriter::flush()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	std::size_t request = ++mFlushRequest;
+	mCondition.notify_all();
+	mCondition.wait( lock, [&]() { return mFlushed >= request; } );
+}
+
+void SeriesWriter::run()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	while( true )
+	{
+		// record() never notifies, so the buffer is drained periodically
+		mCondition.wait_for( lock, WRITE_INTERVAL, [this]() { return mStop || mFlushRequest > mFlushed; } );
+		bool stop = mStop;
+		std::size_t request = mFlushRequest;
+		lock.unlock();
+
+		bool wrote = drain();
+		if( wrote || request > mFlushed )
+			std::fflush( mFile );
+
+		lock.lock();
+		mFlushed = request;
+		mCondition.notify_all();
+		if( stop )
+			return;
+	}
+}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace metrics
+{
+	/*! \class IMetricsSink
+		\brief Receives rows of a time series with a fixed set of columns.
+		\details record() is called from the training loop and must never block it.
+	*/
+	class IMetricsSink
+	{
+	public:
+		virtual ~IMetricsSink() = default;
+
+		// one value per column. Returns false if the row had to be dropped.
+		virtual bool record( const double* values ) = 0;
+		// as above. Rows with the wrong number of values are rejected.
+		bool record( std::initializer_list<double> values )
+		{
+			assert( values.size() == getColumns().size() );
+			return values.size() == getColumns().size() && record( values.begin() );
+		}
+
+		virtual const std::vector<std::string>& getColumns() const = 0;
+	};
+
+	/*! \class SeriesWriter
+		\brief Writes a time series to a CSV or binary file on a background thread.
+		\details Each row is prefixed with the time in seconds since the writer was created.
+				record() only copies the row into a preallocated ring buffer, which is drained by the
+				writer thread a few times per second. If the writer falls behind and the buffer is full,
+				rows are dropped and counted instead of blocking the caller. There must be only one
+				thread that calls record().
+				The binary format starts with the magic "DQNSERIES", the number of columns as uint32
+				and the zero terminated column names, followed by the rows as native doubles.
+	*/
+	class SeriesWriter final : public IMetricsSink
+	{
+	public:
+		enum class Format { CSV, BINARY };
+
+		// Throws std::runtime_error if the file cannot be opened.
+		SeriesWriter( const std::string& path, std::vector<std::string> columns, Format format = Format::CSV,
+					  std::size_t capacity = 4096 );
+		// writes the remaining rows and closes the file
+		~SeriesWriter();
+
+		SeriesWriter( const SeriesWriter& ) = delete;
+		SeriesWriter& operator=( const SeriesWriter& ) = delete;
+
+		using IMetricsSink::record;
+		bool record( const double* values ) override;
+		const std::vector<std::string>& getColumns() const override { return mColumns; }
+
+		// blocks until all rows recorded so far are written and flushed
+		void flush();
+		std::size_t getDropped() const { return mDropped.load( std::memory_order_relaxed ); }
+
+	private:
+		void run();
+		// writes all rows up to the current head, returns false if there were none
+		bool drain();
+		void writeHeader();
+
+		std::vector<std::string> mColumns;
+		std::size_t mWidth;				// values per row, including the time
+		Format mFormat;
+		std::FILE* mFile;
+		std::chrono::steady_clock::time_point mStart;
+
+		// ring buffer of rows. mHead is only written by record(), mTail only by the writer thread.
+		std::vector<double> mRows;
+		std::size_t mCapacity;
+		std::atomic<std::size_t> mHead{0};
+		std::atomic<std::size_t> mTail{0};
+		std::atomic<std::size_t> mDropped{0};
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		bool mStop = false;
+		std::size_t mFlushRequest = 0;
+		std::size_t mFlushed = 0;
+		std::thread mThread;
+	};
+}
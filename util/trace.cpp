@@ -0,0 +1,299 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+namespace trace
+{
+namespace
+{
+	// counters of one site in one thread. They are only written by the owning thread, and read
+	// by others, so relaxed atomics suffice.
+	struct Counters
+	{
+		std::atomic<std::uint64_t> count;
+		std::atomic<std::uint64_t> total;
+		std::atomic<std::uint64_t> max;
+		std::atomic<std::uint64_t> histogram[HISTOGRAM_BUCKETS];
+		
+		Counters() { clear(); }
+		
+		void clear()
+		{
+			count.store( 0, std::memory_order_relaxed );
+			total.store( 0, std::memory_order_relaxed );
+			max.store( 0, std::memory_order_relaxed );
+			for(auto& bucket : histogram)
+				bucket.store( 0, std::memory_order_relaxed );
+		}
+		
+		void addTo( SiteSummary& summary ) const
+		{
+			summary.count += count.load( std::memory_order_relaxed );
+			summary.total_ns += total.load( std::memory_order_relaxed );
+			summary.max_ns = std::max<std::uint64_t>( summary.max_ns, max.load( std::memory_order_relaxed ) );
+			for(std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+				summary.histogram[i] += histogram[i].load( std::memory_order_relaxed );
+		}
+	};
+	
+	// single-writer increment, cheaper than fetch_add
+	void increment( std::atomic<std::uint64_t>& value, std::uint64_t amount )
+	{
+		value.store( value.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed );
+	}
+	
+	struct Event
+	{
+		std::uint32_t site;
+		std::uint32_t thread;
+		std::uint64_t start_ns;
+		std::uint64_t duration_ns;
+	};
+	
+	struct ThreadData
+	{
+		ThreadData();
+		~ThreadData();
+		
+		Counters counters[MAX_SITES];
+		// the reset generation the counters belong to. Counters of an older generation are cleared by
+		// the owning thread before its next measurement, and are ignored until then.
+		std::atomic<std::uint64_t> generation;
+		std::uint32_t id;
+		std::mutex event_mutex;		// only contended while events are exported
+		std::vector<Event> events;
+		
+		// whether the counters have not been reset since they were last written. Called by other threads
+		// while holding the registry mutex.
+		bool current() const;
+	};
+	
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<const Site*> sites;
+		std::vector<ThreadData*> threads;
+		std::uint32_t next_thread = 0;
+		// incremented by reset(), only while holding the mutex
+		std::atomic<std::uint64_t> generation{0};
+		
+		// results of threads that have finished
+		SiteSummary retired[MAX_SITES];
+		std::vector<Event> retired_events;
+		
+		std::atomic<bool> chrome_trace{false};
+		std::size_t max_events = 0;
+		clock::time_point epoch = clock::now();
+	};
+	
+	Registry& registry()
+	{
+		static Registry instance;
+		return instance;
+	}
+	
+	ThreadData& threadData()
+	{
+		thread_local ThreadData data;
+		return data;
+	}
+	
+	ThreadData::ThreadData()
+	{
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> lock( reg.mutex );
+		id = reg.next_thread++;
+		generation.store( reg.generation.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+		reg.threads.push_back( this );
+	}
+	
+	bool ThreadData::current() const
+	{
+		// acquire pairs with the release in Scope::~Scope, so the cleared counters are visible
+		return generation.load( std::memory_order_acquire ) == registry().generation.load( std::memory_order_relaxed );
+	}
+	
+	ThreadData::~ThreadData()
+	{
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> lock( reg.mutex );
+		if( current() )
+		{
+			for(std::size_t i = 0; i < MAX_SITES; ++i)
+				counters[i].addTo( reg.retired[i] );
+		}
+		reg.retired_events.insert( reg.retired_events.end(), events.begin(), events.end() );
+		reg.threads.erase( std::find( reg.threads.begin(), reg.threads.end(), this ) );
+	}
+	
+	std::size_t bucket( std::uint64_t ns )
+	{
+		std::size_t b = 0;
+		while( ns > 0 && b < HISTOGRAM_BUCKETS - 1 )
+		{
+			ns >>= 1;
+			++b;
+		}
+		return b;
+	}
+	
+	std::uint64_t toNs( clock::duration d )
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>( d ).count();
+	}
+}
+
+Site::Site( const char* name ) : mName( name )
+{
+	Registry& reg = registry();
+	std::lock_guard<std::mutex> lock( reg.mutex );
+	if( reg.sites.size() >= MAX_SITES )
+		throw std::length_error("too many trace sites, increase trace::MAX_SITES");
+	mId = reg.sites.size();
+	reg.sites.push_back( this );
+}
+
+Scope::~Scope()
+{
+	auto end = clock::now();
+	std::uint64_t ns = toNs( end - mStart );
+	
+	ThreadData& data = threadData();
+	Registry& reg = registry();
+	std::uint64_t generation = reg.generation.load( std::memory_order_relaxed );
+	if( data.generation.load( std::memory_order_relaxed ) != generation )
+	{
+		// reset() only marks the counters as outdated, as it cannot modify them while this thread writes
+		for(auto& site_counters : data.counters)
+			site_counters.clear();
+		data.generation.store( generation, std::memory_order_release );
+	}
+	
+	Counters& counters = data.counters[mSite.id()];
+	increment( counters.count, 1 );
+	increment( counters.total, ns );
+	increment( counters.histogram[bucket(ns)], 1 );
+	if( ns > counters.max.load( std::memory_order_relaxed ) )
+		counters.max.store( ns, std::memory_order_relaxed );
+	
+	if( reg.chrome_trace.load( std::memory_order_relaxed ) )
+	{
+		std::lock_guard<std::mutex> lock( data.event_mutex );
+		if( data.events.size() < reg.max_events )
+			data.events.push_back( Event{ (std::uint32_t)mSite.id(), data.id, toNs( mStart - reg.epoch ), ns } );
+	}
+}
+
+double SiteSummary::quantile_ns( double q ) const
+{
+	std::uint64_t target = q * count;
+	std::uint64_t seen = 0;
+	for(std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		seen += histogram[i];
+		if( seen > target )
+			return i == 0 ? 0 : std::min<double>( std::uint64_t(1) << i, max_ns );
+	}
+	return max_ns;
+}
+
+std::vector<SiteSummary> summary()
+{
+	Registry& reg = registry();
+	std::lock_guard<std::mutex> lock( reg.mutex );
+	std::vector<SiteSummary> result( reg.sites.size() );
+	for(std::size_t i = 0; i < reg.sites.size(); ++i)
+	{
+		result[i] = reg.retired[i];
+		result[i].name = reg.sites[i]->name();
+		for(const ThreadData* thread : reg.threads)
+		{
+			if( thread->current() )
+				thread->counters[i].addTo( result[i] );
+		}
+	}
+	return result;
+}
+
+void reset()
+{
+	Registry& reg = registry();
+	std::lock_guard<std::mutex> lock( reg.mutex );
+	for(auto& retired : reg.retired)
+		retired = SiteSummary();
+	reg.retired_events.clear();
+	// the counters of running threads are cleared by their owners, see Scope::~Scope
+	reg.generation.fetch_add( 1, std::memory_order_relaxed );
+	for(ThreadData* thread : reg.threads)
+	{
+		std::lock_guard<std::mutex> event_lock( thread->event_mutex );
+		thread->events.clear();
+	}
+}
+
+void report( std::ostream& out )
+{
+	out << std::left << std::setw(36) << "site" << std::right
+		<< std::setw(12) << "count" << std::setw(12) << "total ms" << std::setw(12) << "mean us"
+		<< std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "\n";
+	auto flags = out.flags();
+	auto precision = out.precision( 3 );
+	out << std::fixed;
+	for(const auto& site : summary())
+	{
+		if( site.count == 0 )
+			continue;
+		out << std::left << std::setw(36) << site.name << std::right
+			<< std::setw(12) << site.count << std::setw(12) << site.total_ns / 1e6
+			<< std::setw(12) << site.mean_ns() / 1e3 << std::setw(12) << site.quantile_ns(0.5) / 1e3
+			<< std::setw(12) << site.quantile_ns(0.99) / 1e3 << std::setw(12) << site.max_ns / 1e3 << "\n";
+	}
+	out.flags( flags );
+	out.precision( precision );
+}
+
+void enableChromeTrace( bool enable, std::size_t max_events )
+{
+	Registry& reg = registry();
+	{
+		std::lock_guard<std::mutex> lock( reg.mutex );
+		reg.max_events = max_events;
+	}
+	reg.chrome_trace.store( enable );
+}
+
+void writeChromeTrace( std::ostream& out )
+{
+	Registry& reg = registry();
+	std::lock_guard<std::mutex> lock( reg.mutex );
+	
+	bool first = true;
+	auto write = [&]( const Event& event )
+	{
+		out << (first ? "\n" : ",\n");
+		first = false;
+		out << "{\"name\":\"" << reg.sites[event.site]->name() << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+			<< ",\"ts\":" << event.start_ns / 1e3 << ",\"dur\":" << event.duration_ns / 1e3 << "}";
+	};
+	
+	auto flags = out.flags();
+	auto precision = out.precision( 3 );
+	out << std::fixed << "{\"traceEvents\":[";
+	for(const auto& event : reg.retired_events)
+		write( event );
+	for(ThreadData* thread : reg.threads)
+	{
+		std::lock_guard<std::mutex> event_lock( thread->event_mutex );
+		for(const auto& event : thread->events)
+			write( event );
+	}
+	out << "\n]}\n";
+	out.flags( flags );
+	out.precision( precision );
+}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+/*! \file trace.hpp
+	\brief Low overhead scoped timers for the hot paths.
+	\details DQN_TRACE_SCOPE("name") measures the time until the end of the enclosing scope. The
+			measurements are collected in per-thread counters and log2 histograms, which are only
+			written by their own thread, so recording needs no locks. If chrome tracing is enabled
+			at runtime, each scope is additionally recorded as an event that can be exported in the
+			Chrome trace event format (chrome://tracing, Perfetto).
+			Unless DQN_TRACING is defined, DQN_TRACE_SCOPE expands to nothing.
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace trace
+{
+	using clock = std::chrono::steady_clock;
+
+	// maximum number of distinct trace sites
+	const std::size_t MAX_SITES = 64;
+	// number of log2 histogram buckets, bucket i counts durations in [2^(i-1), 2^i) ns
+	const std::size_t HISTOGRAM_BUCKETS = 40;
+
+	// a code location that is traced. Sites are static objects created by DQN_TRACE_SCOPE.
+	class Site
+	{
+	public:
+		explicit Site( const char* name );
+		const char* name() const { return mName; }
+		std::size_t id() const { return mId; }
+	private:
+		const char* mName;
+		std::size_t mId;
+	};
+
+	// aggregated statistics of one site over all threads
+	struct SiteSummary
+	{
+		std::string name;
+		std::uint64_t count = 0;
+		std::uint64_t total_ns = 0;
+		std::uint64_t max_ns = 0;
+		std::uint64_t histogram[HISTOGRAM_BUCKETS] = {};
+
+		double mean_ns() const { return count ? double(total_ns) / count : 0; }
+		// approximate quantile q in [0, 1], upper bound of the histogram bucket that contains it.
+		double quantile_ns( double q ) const;
+	};
+
+	// records the time of a scope. Use DQN_TRACE_SCOPE instead of using this directly.
+	class Scope
+	{
+	public:
+		explicit Scope( const Site& site ) : mSite( site ), mStart( clock::now() ) {}
+		~Scope();
+		Scope( const Scope& ) = delete;
+		Scope& operator=( const Scope& ) = delete;
+	private:
+		const Site& mSite;
+		clock::time_point mStart;
+	};
+
+	// statistics of all sites, summed over all threads, including threads that have finished.
+	// can be called while other threads are recording.
+	std::vector<SiteSummary> summary();
+
+	// resets all counters and drops all recorded events. Can be called while other threads are
+	// recording; their counters are cleared by themselves on their next measurement.
+	void reset();
+
+	// prints a table of all sites to out.
+	void report( std::ostream& out );
+
+	// enables or disables recording of individual events for the chrome trace export.
+	// at most max_events are kept per thread, further events are dropped.
+	void enableChromeTrace( bool enable, std::size_t max_events = 1 << 20 );
+
+	// writes all recorded events in the Chrome trace event (JSON) format.
+	void writeChromeTrace( std::ostream& out );
+}
+
+#define DQN_TRACE_CONCAT_IMPL(a, b) a##b
+#define DQN_TRACE_CONCAT(a, b) DQN_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef DQN_TRACING
+#define DQN_TRACE_SCOPE(name) \
+	static const ::trace::Site DQN_TRACE_CONCAT(dqn_trace_site_, __LINE__)( name ); \
+	::trace::Scope DQN_TRACE_CONCAT(dqn_trace_scope_, __LINE__)( DQN_TRACE_CONCAT(dqn_trace_site_, __LINE__) )
+#else
+#define DQN_TRACE_SCOPE(name) do {} while(false)
+#endif